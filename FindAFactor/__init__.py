@@ -1 +1 @@
-from .find_a_factor import find_a_factor, FactoringMethod
\ No newline at end of file
+from .find_a_factor import find_a_factor, FactoringMethod, block_wiedemann, block_wiedemann_part, block_wiedemann_solve, merge_relations, export_relations, import_relations, export_matrix, solve_dependencies, pollard_rho_batch, find_factors_u64, factor_range
\ No newline at end of file
@@ -0,0 +1,46 @@
+import argparse
+from .find_a_factor import merge_relations, export_relations, import_relations, export_matrix, solve_dependencies
+
+
+def main():
+    parser = argparse.ArgumentParser(prog='python -m FindAFactor', description='FindAFactor command line tools')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    merge = subparsers.add_parser('merge', help='merge relation matrix files from independent nodes, and solve the union for a factor')
+    merge.add_argument('matrix_files', nargs='+', help='relation matrix files, written by find_a_factor() with matrix_file and sieve_only')
+    merge.add_argument('-o', '--output', default='', help='write the merged relation matrix to this file, and solve it with Block Wiedemann')
+    merge.add_argument('-p', '--wiedemann-process-count', type=int, default=1, help='local processes for Block Wiedemann (with --output)')
+
+    export_rel = subparsers.add_parser('export-relations', help='write the relations in a relation matrix file as CADO-NFS style text')
+    export_rel.add_argument('matrix_file')
+    export_rel.add_argument('relation_file')
+
+    import_rel = subparsers.add_parser('import-relations', help='read CADO-NFS style text relations into a relation matrix file')
+    import_rel.add_argument('n', help='the number that the relations factor')
+    import_rel.add_argument('relation_file')
+    import_rel.add_argument('matrix_file')
+
+    export_mat = subparsers.add_parser('export-matrix', help='write the filtered relation matrix for an external solver')
+    export_mat.add_argument('matrix_file')
+    export_mat.add_argument('out_file')
+    export_mat.add_argument('-f', '--format', default='cado', choices=['cado', 'cado-bin', 'msieve'])
+
+    solve_dep = subparsers.add_parser('solve-dependencies', help='find a factor from an external solver\'s dependency file')
+    solve_dep.add_argument('matrix_file')
+    solve_dep.add_argument('dependency_file')
+
+    args = parser.parse_args()
+    if args.command == 'merge':
+        print(merge_relations(args.matrix_files, args.output, args.wiedemann_process_count))
+    elif args.command == 'export-relations':
+        export_relations(args.matrix_file, args.relation_file)
+    elif args.command == 'import-relations':
+        import_relations(args.n, args.relation_file, args.matrix_file)
+    elif args.command == 'export-matrix':
+        export_matrix(args.matrix_file, args.out_file, args.format)
+    elif args.command == 'solve-dependencies':
+        print(solve_dependencies(args.matrix_file, args.dependency_file))
+
+
+if __name__ == '__main__':
+    main()
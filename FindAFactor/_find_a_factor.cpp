@@ -13,18 +13,33 @@
 // https://opensource.org/license/mit for details.
 
 #include "dispatchqueue.hpp"
+#include "mapped_file.hpp"
 #include "wheel_factorization.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
 #include <future>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
 #include <stdlib.h>
 #include <string>
 
+#include <boost/crc.hpp>
 #include <boost/dynamic_bitset.hpp>
+#include <boost/multiprecision/miller_rabin.hpp>
 
+#include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -364,8 +379,690 @@ std::vector<size_t> selectFactorBase(const BigInteger N, const std::vector<size_
 //                              WRITTEN WITH HELP FROM ELARA (GPT) ABOVE                                  //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Structured Gaussian elimination ("filtering") shrinks the relation matrix before either solver sees it.
+// A prime that divides only one relation (to an odd power) keeps that relation out of every dependency,
+// so both are dropped. A prime that divides exactly two relations is eliminated by merging them into one row.
+// Finally, the heaviest relations are dropped, down to the requested surplus of rows over live columns.
+// Every surviving row lists the original relations that it multiplies together.
+struct FilteredRelations {
+  size_t columnCount;
+  std::vector<boost::dynamic_bitset<size_t>> rows;
+  std::vector<std::vector<size_t>> members;
+
+  FilteredRelations(const std::vector<boost::dynamic_bitset<size_t>> &relations, size_t primeCount, size_t surplus)
+    : columnCount(0U)
+  {
+    const size_t relationCount = relations.size();
+    std::vector<std::vector<size_t>> sparse(relationCount);
+    std::vector<std::vector<size_t>> groups(relationCount);
+    std::vector<bool> isLive(relationCount, true);
+    // Column lists can go stale as rows merge, so they are pruned on use, while weights are always exact.
+    std::vector<std::vector<size_t>> columnRows(primeCount);
+    std::vector<size_t> weight(primeCount, 0U);
+    for (size_t row = 0U; row < relationCount; ++row) {
+      const boost::dynamic_bitset<size_t> &rfv = relations[row];
+      for (size_t pid = rfv.find_first(); pid != boost::dynamic_bitset<size_t>::npos; pid = rfv.find_next(pid)) {
+        sparse[row].push_back(pid);
+        columnRows[pid].push_back(row);
+        ++weight[pid];
+      }
+      groups[row].push_back(row);
+    }
+    size_t liveRows = relationCount;
+    size_t liveColumns = std::count_if(weight.begin(), weight.end(), [](const size_t &w) { return w > 0U; });
+
+    const auto removeRow = [&](size_t row) {
+      for (const size_t &pid : sparse[row]) {
+        if (!--weight[pid]) {
+          --liveColumns;
+        }
+      }
+      sparse[row].clear();
+      groups[row].clear();
+      isLive[row] = false;
+      --liveRows;
+    };
+    const auto mergeRows = [&](size_t keep, size_t drop) {
+      std::vector<size_t> merged;
+      std::set_symmetric_difference(sparse[keep].begin(), sparse[keep].end(), sparse[drop].begin(), sparse[drop].end(), std::back_inserter(merged));
+      for (const size_t &pid : sparse[drop]) {
+        if (!std::binary_search(sparse[keep].begin(), sparse[keep].end(), pid)) {
+          // The prime moves from one row to the other.
+          columnRows[pid].push_back(keep);
+        } else if (!(weight[pid] -= 2U)) {
+          --liveColumns;
+        }
+      }
+      sparse[keep].swap(merged);
+      groups[keep].insert(groups[keep].end(), groups[drop].begin(), groups[drop].end());
+      sparse[drop].clear();
+      groups[drop].clear();
+      isLive[drop] = false;
+      --liveRows;
+    };
+    const auto rowsOf = [&](size_t pid) -> const std::vector<size_t> & {
+      std::vector<size_t> &cr = columnRows[pid];
+      cr.erase(std::remove_if(cr.begin(), cr.end(), [&](const size_t &row) {
+        return !isLive[row] || !std::binary_search(sparse[row].begin(), sparse[row].end(), pid);
+      }), cr.end());
+      std::sort(cr.begin(), cr.end());
+      cr.erase(std::unique(cr.begin(), cr.end()), cr.end());
+
+      return cr;
+    };
+
+    // Every pass removes at least one row, until nothing changes.
+    for (bool isChanged = true; isChanged;) {
+      isChanged = false;
+      for (size_t pid = 0U; pid < primeCount; ++pid) {
+        if (weight[pid] == 1U) {
+          removeRow(rowsOf(pid).front());
+          isChanged = true;
+        } else if (weight[pid] == 2U) {
+          const std::vector<size_t> &cr = rowsOf(pid);
+          const size_t keep = cr[0U], drop = cr[1U];
+          mergeRows(keep, drop);
+          isChanged = true;
+        }
+      }
+
+      // Removing a row costs at most one row of surplus, while singletons and merges cost none.
+      if (liveRows > (liveColumns + surplus)) {
+        std::vector<size_t> byWeight;
+        for (size_t row = 0U; row < relationCount; ++row) {
+          if (isLive[row]) {
+            byWeight.push_back(row);
+          }
+        }
+        std::stable_sort(byWeight.begin(), byWeight.end(), [&sparse](const size_t &a, const size_t &b) { return sparse[a].size() > sparse[b].size(); });
+        const size_t excess = liveRows - (liveColumns + surplus);
+        for (size_t i = 0U; i < excess; ++i) {
+          removeRow(byWeight[i]);
+        }
+        isChanged = true;
+      }
+    }
+
+    // Renumber the live columns, and emit the live rows.
+    std::vector<size_t> columnIds(primeCount, 0U);
+    for (size_t pid = 0U; pid < primeCount; ++pid) {
+      if (weight[pid]) {
+        columnIds[pid] = columnCount++;
+      }
+    }
+    for (size_t row = 0U; row < relationCount; ++row) {
+      if (!isLive[row]) {
+        continue;
+      }
+      boost::dynamic_bitset<size_t> rfv(columnCount, 0U);
+      for (const size_t &pid : sparse[row]) {
+        rfv.set(columnIds[pid]);
+      }
+      rows.push_back(rfv);
+      std::sort(groups[row].begin(), groups[row].end());
+      members.push_back(groups[row]);
+    }
+  }
+
+  // Map dependencies among filtered rows back to dependencies among the original relations.
+  // (Every original relation belongs to at most one filtered row.)
+  std::vector<std::vector<size_t>> expand(const std::vector<std::vector<size_t>> &solutions) const {
+    std::vector<std::vector<size_t>> expanded;
+    for (const std::vector<size_t> &solution : solutions) {
+      std::vector<size_t> selectedRows;
+      for (const size_t &row : solution) {
+        selectedRows.insert(selectedRows.end(), members[row].begin(), members[row].end());
+      }
+      std::sort(selectedRows.begin(), selectedRows.end());
+      expanded.push_back(selectedRows);
+    }
+
+    return expanded;
+  }
+};
+
+// Above this many (filtered) matrix columns, dense Gaussian elimination is replaced by Block Lanczos.
+const size_t BlockLanczosThreshold = 4096U;
+
+// A GF(2) block of 64 vectors is stored as one 64-bit word per matrix row.
+// A 64x64 GF(2) matrix is 64 such words, where bit j of word i is entry (i, j).
+typedef uint64_t BlockWord;
+
+// The relation matrix for Block Lanczos, in compressed sparse row (CSR) form:
+// each row is one relation, listing the indices of the smooth primes that
+// divide its residue an odd number of times.
+struct SparseParityMatrix {
+  size_t primeCount;
+  std::vector<size_t> rowStarts;
+  std::vector<size_t> primeIds;
+
+  SparseParityMatrix(const std::vector<boost::dynamic_bitset<size_t>> &rows, size_t pc)
+    : primeCount(pc)
+  {
+    rowStarts.reserve(rows.size() + 1U);
+    rowStarts.push_back(0U);
+    for (const boost::dynamic_bitset<size_t> &row : rows) {
+      for (size_t pid = row.find_first(); pid != boost::dynamic_bitset<size_t>::npos; pid = row.find_next(pid)) {
+        primeIds.push_back(pid);
+      }
+      rowStarts.push_back(primeIds.size());
+    }
+  }
+
+  size_t rowCount() const { return rowStarts.size() - 1U; }
+
+  // Relations are split into one contiguous slice per thread.
+  size_t sliceSize() const { return (rowCount() + CpuCount - 1U) / CpuCount; }
+
+  // out = M^T * v, as one 64-bit block per prime.
+  // Each thread accumulates its slice of relations into private scratch, then the scratch is reduced.
+  void multiplyTransposed(const std::vector<BlockWord> &v, std::vector<BlockWord> &out, std::vector<std::vector<BlockWord>> &scratch) const {
+    const size_t slice = sliceSize();
+    scratch.resize(CpuCount);
+    for (size_t cpu = 0U; cpu < CpuCount; ++cpu) {
+      dispatch.dispatch([this, cpu, slice, &v, &scratch]() -> bool {
+        std::vector<BlockWord> &acc = scratch[cpu];
+        acc.assign(primeCount, 0U);
+        const size_t maxRow = std::min((cpu + 1U) * slice, rowCount());
+        for (size_t row = cpu * slice; row < maxRow; ++row) {
+          const BlockWord w = v[row];
+          if (!w) {
+            continue;
+          }
+          for (size_t i = rowStarts[row]; i < rowStarts[row + 1U]; ++i) {
+            acc[primeIds[i]] ^= w;
+          }
+        }
+
+        return false;
+      });
+    }
+    dispatch.finish();
+
+    out.assign(primeCount, 0U);
+    const size_t primeSlice = (primeCount + CpuCount - 1U) / CpuCount;
+    for (size_t cpu = 0U; cpu < CpuCount; ++cpu) {
+      dispatch.dispatch([cpu, primeSlice, &out, &scratch]() -> bool {
+        const size_t maxPid = std::min((cpu + 1U) * primeSlice, out.size());
+        for (const std::vector<BlockWord> &acc : scratch) {
+          for (size_t pid = cpu * primeSlice; pid < maxPid; ++pid) {
+            out[pid] ^= acc[pid];
+          }
+        }
+
+        return false;
+      });
+    }
+    dispatch.finish();
+  }
+
+  // out = M * u, as one 64-bit block per relation.
+  void multiply(const std::vector<BlockWord> &u, std::vector<BlockWord> &out) const {
+    const size_t slice = sliceSize();
+    out.resize(rowCount());
+    for (size_t cpu = 0U; cpu < CpuCount; ++cpu) {
+      dispatch.dispatch([this, cpu, slice, &u, &out]() -> bool {
+        const size_t maxRow = std::min((cpu + 1U) * slice, rowCount());
+        for (size_t row = cpu * slice; row < maxRow; ++row) {
+          BlockWord w = 0U;
+          for (size_t i = rowStarts[row]; i < rowStarts[row + 1U]; ++i) {
+            w ^= u[primeIds[i]];
+          }
+          out[row] = w;
+        }
+
+        return false;
+      });
+    }
+    dispatch.finish();
+  }
+
+  // out = A * v, for the square operator A that is M^T with its rows folded modulo the relation count.
+  // (With at least as many relations as primes, this just pads M^T with zero rows.)
+  void multiplyFolded(const std::vector<BlockWord> &v, std::vector<BlockWord> &out, std::vector<BlockWord> &tmp,
+                      std::vector<std::vector<BlockWord>> &scratch) const {
+    multiplyTransposed(v, tmp, scratch);
+    out.assign(rowCount(), 0U);
+    for (size_t pid = 0U; pid < tmp.size(); ++pid) {
+      out[pid % out.size()] ^= tmp[pid];
+    }
+  }
+
+  // out = (M * M^T) * v, the symmetric operator that Block Lanczos iterates upon.
+  void multiplySymmetric(const std::vector<BlockWord> &v, std::vector<BlockWord> &out, std::vector<BlockWord> &tmp,
+                         std::vector<std::vector<BlockWord>> &scratch) const {
+    multiplyTransposed(v, tmp, scratch);
+    multiply(tmp, out);
+  }
+};
+
+// c = a * b, for 64x64 GF(2) matrices ("c" may alias "a" or "b")
+void mul64x64(const BlockWord *a, const BlockWord *b, BlockWord *c) {
+  BlockWord t[64U];
+  for (size_t i = 0U; i < 64U; ++i) {
+    BlockWord w = 0U;
+    for (size_t j = 0U; j < 64U; ++j) {
+      if ((a[i] >> j) & 1U) {
+        w ^= b[j];
+      }
+    }
+    t[i] = w;
+  }
+  std::copy(t, t + 64U, c);
+}
+
+// y += v * m, for (n x 64) blocks "v" and "y" and a 64x64 matrix "m"
+void mulNx64x64Acc(const std::vector<BlockWord> &v, const BlockWord *m, std::vector<BlockWord> &y) {
+  // Tabulate every combination of each group of 8 rows of "m".
+  std::unique_ptr<BlockWord[]> uTable(new BlockWord[8U * 256U]());
+  BlockWord *table = uTable.get();
+  for (size_t g = 0U; g < 8U; ++g) {
+    BlockWord *t = table + (g << 8U);
+    for (size_t bit = 0U; bit < 8U; ++bit) {
+      const size_t high = 1U << bit;
+      for (size_t b = high; b < (high << 1U); ++b) {
+        t[b] = t[b ^ high] ^ m[(g << 3U) + bit];
+      }
+    }
+  }
+
+  const size_t slice = (v.size() + CpuCount - 1U) / CpuCount;
+  for (size_t cpu = 0U; cpu < CpuCount; ++cpu) {
+    dispatch.dispatch([cpu, slice, table, &v, &y]() -> bool {
+      const size_t maxRow = std::min((cpu + 1U) * slice, v.size());
+      for (size_t row = cpu * slice; row < maxRow; ++row) {
+        const BlockWord w = v[row];
+        if (!w) {
+          continue;
+        }
+        BlockWord acc = 0U;
+        for (size_t g = 0U; g < 8U; ++g) {
+          acc ^= table[(g << 8U) | ((w >> (g << 3U)) & 255U)];
+        }
+        y[row] ^= acc;
+      }
+
+      return false;
+    });
+  }
+  dispatch.finish();
+}
+
+// xy = x^T * y, for (n x 64) blocks "x" and "y"
+void mul64xNx64(const std::vector<BlockWord> &x, const std::vector<BlockWord> &y, BlockWord *xy) {
+  // Each thread sums "y" rows into buckets per byte value of "x" rows.
+  std::vector<std::vector<BlockWord>> tables(CpuCount);
+  const size_t slice = (x.size() + CpuCount - 1U) / CpuCount;
+  for (size_t cpu = 0U; cpu < CpuCount; ++cpu) {
+    dispatch.dispatch([cpu, slice, &x, &y, &tables]() -> bool {
+      std::vector<BlockWord> &t = tables[cpu];
+      t.assign(8U * 256U, 0U);
+      const size_t maxRow = std::min((cpu + 1U) * slice, x.size());
+      for (size_t row = cpu * slice; row < maxRow; ++row) {
+        const BlockWord w = x[row];
+        if (!w) {
+          continue;
+        }
+        for (size_t g = 0U; g < 8U; ++g) {
+          t[(g << 8U) | ((w >> (g << 3U)) & 255U)] ^= y[row];
+        }
+      }
+
+      return false;
+    });
+  }
+  dispatch.finish();
+
+  std::fill(xy, xy + 64U, 0U);
+  for (const std::vector<BlockWord> &t : tables) {
+    for (size_t g = 0U; g < 8U; ++g) {
+      for (size_t b = 1U; b < 256U; ++b) {
+        const BlockWord w = t[(g << 8U) | b];
+        for (size_t bit = 0U; bit < 8U; ++bit) {
+          if ((b >> bit) & 1U) {
+            xy[(g << 3U) + bit] ^= w;
+          }
+        }
+      }
+    }
+  }
+}
+
+// Select the columns "s" of the symmetric 64x64 matrix "t" for which the submatrix
+// is invertible, preferring columns that were not selected on the last iteration,
+// and write that submatrix inverse into "w". Returns the count of selected columns.
+// (This is the procedure from Montgomery's 1995 paper on Block Lanczos.)
+size_t findNonsingularSub(const BlockWord *t, size_t *s, const size_t *lastS, size_t lastDim, BlockWord *w) {
+  BlockWord m[64U][2U];
+  for (size_t i = 0U; i < 64U; ++i) {
+    m[i][0U] = t[i];
+    m[i][1U] = 1ULL << i;
+  }
+
+  BlockWord mask = 0U;
+  for (size_t i = 0U; i < lastDim; ++i) {
+    mask |= 1ULL << lastS[i];
+    s[63U - i] = lastS[i];
+  }
+  for (size_t i = 0U, j = 0U; i < 64U; ++i) {
+    if (!((mask >> i) & 1U)) {
+      s[j++] = i;
+    }
+  }
+
+  size_t dim = 0U;
+  for (size_t i = 0U; i < 64U; ++i) {
+    mask = 1ULL << s[i];
+    BlockWord *rowI = m[s[i]];
+
+    // Find the next pivot row, and put it in row i.
+    size_t j = i;
+    for (; j < 64U; ++j) {
+      BlockWord *rowJ = m[s[j]];
+      if (rowJ[0U] & mask) {
+        std::swap(rowI[0U], rowJ[0U]);
+        std::swap(rowI[1U], rowJ[1U]);
+        break;
+      }
+    }
+
+    if (j < 64U) {
+      for (j = 0U; j < 64U; ++j) {
+        BlockWord *rowJ = m[s[j]];
+        if ((rowI != rowJ) && (rowJ[0U] & mask)) {
+          rowJ[0U] ^= rowI[0U];
+          rowJ[1U] ^= rowI[1U];
+        }
+      }
+      s[dim++] = s[i];
+      continue;
+    }
+
+    // Otherwise, use the identity half to compensate for the missing pivot.
+    for (j = i; j < 64U; ++j) {
+      BlockWord *rowJ = m[s[j]];
+      if (rowJ[1U] & mask) {
+        std::swap(rowI[0U], rowJ[0U]);
+        std::swap(rowI[1U], rowJ[1U]);
+        break;
+      }
+    }
+    if (j == 64U) {
+      // The submatrix is not invertible.
+      return 0U;
+    }
+    for (j = 0U; j < 64U; ++j) {
+      BlockWord *rowJ = m[s[j]];
+      if ((rowI != rowJ) && (rowJ[1U] & mask)) {
+        rowJ[0U] ^= rowI[0U];
+        rowJ[1U] ^= rowI[1U];
+      }
+    }
+    rowI[0U] = 0U;
+    rowI[1U] = 0U;
+  }
+
+  for (size_t i = 0U; i < 64U; ++i) {
+    w[i] = m[i][1U];
+  }
+
+  return dim;
+}
+
+// Binary file fields are native-endian 64-bit words, and strings are length-prefixed.
+const std::string RelationMatrixMagic = "FindAFactor relation matrix v1";
+const std::string KrylovPartMagic = "FindAFactor Krylov sequence part v1";
+
+void writeWord(std::ostream &out, uint64_t w) { out.write(reinterpret_cast<const char *>(&w), sizeof(w)); }
+
+uint64_t readWord(std::istream &in) {
+  uint64_t w = 0U;
+  if (!in.read(reinterpret_cast<char *>(&w), sizeof(w))) {
+    throw std::runtime_error("Unexpected end of FindAFactor binary file!");
+  }
+
+  return w;
+}
+
+void writeString(std::ostream &out, const std::string &str) {
+  writeWord(out, str.size());
+  out.write(str.data(), str.size());
+}
+
+std::string readString(std::istream &in) {
+  std::string str(readWord(in), '\0');
+  if (!in.read(&(str[0U]), str.size())) {
+    throw std::runtime_error("Unexpected end of FindAFactor binary file!");
+  }
+
+  return str;
+}
+
+// The relation log is an append-only checkpoint of FACTOR_FINDER sieving: after the magic string, every record is
+// a frame of [payload size][payload][CRC-32 of payload]. The first payload is the run's fingerprint (the number to factor
+// and every parameter that shapes sieving), and each later payload is either a relation or a completed batch index.
+// A frame that was torn by a crash fails its size or CRC check, and it (with anything after it) is cut off on resume.
+const std::string RelationLogMagic = "FindAFactor relation log v1";
+
+enum RelationLogRecord { RELATION_LOG_FINGERPRINT = 0, RELATION_LOG_RELATION = 1, RELATION_LOG_BATCH_DONE = 2 };
+
+uint64_t crc32(const std::string &payload) {
+  boost::crc_32_type crc;
+  crc.process_bytes(payload.data(), payload.size());
+
+  return crc.checksum();
+}
+
+// Frames are queued by sieving threads and written out (and flushed) by one background writer,
+// so sieving never waits on the disk.
+class RelationLog {
+public:
+  std::vector<BigInteger> restoredKeys;
+  std::vector<std::vector<size_t>> restoredPrimeIds;
+  std::vector<size_t> restoredBatches;
+
+  // Open (or create) the log at "path", restoring its records if it belongs to the same "fingerprint".
+  RelationLog(const std::string &path, const std::string &fingerprint) : isStopping(false) {
+    std::string data;
+    {
+      std::ifstream in(path, std::ios::binary);
+      if (in) {
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+      }
+    }
+
+    std::ostringstream magic;
+    writeString(magic, RelationLogMagic);
+    const std::string header = magic.str();
+    if (data.compare(0U, header.size(), header)) {
+      // Only a log that was torn while writing its header can start with a partial header.
+      if (header.compare(0U, data.size(), data)) {
+        throw std::runtime_error("Not a FindAFactor relation log file: " + path);
+      }
+      data.clear();
+    }
+
+    size_t validBytes = 0U;
+    if (!data.empty()) {
+      validBytes = header.size();
+      bool isFirst = true;
+      std::string payload;
+      while (readFrame(data, validBytes, payload)) {
+        std::istringstream record(payload);
+        const size_t type = readWord(record);
+        if (isFirst) {
+          if ((type != RELATION_LOG_FINGERPRINT) || (readString(record) != fingerprint)) {
+            throw std::runtime_error("Relation log belongs to a different number or different sieving parameters: " + path);
+          }
+          isFirst = false;
+        } else if (type == RELATION_LOG_RELATION) {
+          restoredKeys.emplace_back(readString(record));
+          std::vector<size_t> primeIds(readWord(record));
+          for (size_t &pid : primeIds) {
+            pid = readWord(record);
+          }
+          restoredPrimeIds.push_back(primeIds);
+        } else if (type == RELATION_LOG_BATCH_DONE) {
+          restoredBatches.push_back(readWord(record));
+        }
+      }
+      if (isFirst) {
+        // Not even the fingerprint survived, so start over.
+        validBytes = 0U;
+      }
+    }
+
+    if (!validBytes) {
+      std::ofstream out(path, std::ios::binary | std::ios::trunc);
+      writeString(out, RelationLogMagic);
+      std::ostringstream record;
+      writeWord(record, RELATION_LOG_FINGERPRINT);
+      writeString(record, fingerprint);
+      out << frame(record.str());
+      if (!out) {
+        throw std::runtime_error("Could not write relation log file: " + path);
+      }
+    } else if (validBytes < data.size()) {
+      // Cut off a torn tail, through a temporary copy, so a crash now can't lose the good records.
+      const std::string tmpPath = path + ".tmp";
+      {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), validBytes);
+        if (!out) {
+          throw std::runtime_error("Could not write relation log file: " + tmpPath);
+        }
+      }
+      std::remove(path.c_str());
+      if (std::rename(tmpPath.c_str(), path.c_str())) {
+        throw std::runtime_error("Could not replace relation log file: " + path);
+      }
+    }
+
+    out.open(path, std::ios::binary | std::ios::app);
+    if (!out) {
+      throw std::runtime_error("Could not open relation log file for appending: " + path);
+    }
+    writer = std::async(std::launch::async, [this] { writeFrames(); });
+  }
+
+  ~RelationLog() {
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+      isStopping = true;
+    }
+    queueCv.notify_one();
+    writer.get();
+  }
+
+  void appendRelation(const BigInteger &key, const boost::dynamic_bitset<size_t> &rfv) {
+    std::ostringstream record;
+    writeWord(record, RELATION_LOG_RELATION);
+    writeString(record, boost::lexical_cast<std::string>(key));
+    writeWord(record, rfv.count());
+    for (size_t pid = rfv.find_first(); pid != boost::dynamic_bitset<size_t>::npos; pid = rfv.find_next(pid)) {
+      writeWord(record, pid);
+    }
+    enqueue(record.str());
+  }
+
+  void appendBatchDone(size_t batch) {
+    std::ostringstream record;
+    writeWord(record, RELATION_LOG_BATCH_DONE);
+    writeWord(record, batch);
+    enqueue(record.str());
+  }
+
+  // Every batch below this one was completed (and its relations logged) before the last run stopped.
+  size_t restoredBatchNumber() const {
+    std::vector<size_t> batches(restoredBatches);
+    std::sort(batches.begin(), batches.end());
+    size_t next = 0U;
+    for (const size_t &batch : batches) {
+      if (batch > next) {
+        break;
+      }
+      if (batch == next) {
+        ++next;
+      }
+    }
+
+    return next;
+  }
+
+  RelationLog(const RelationLog &) = delete;
+  RelationLog &operator=(const RelationLog &) = delete;
+
+private:
+  std::ofstream out;
+  std::mutex queueMutex;
+  std::condition_variable queueCv;
+  std::vector<std::string> queue;
+  bool isStopping;
+  std::future<void> writer;
+
+  static std::string frame(const std::string &payload) {
+    std::ostringstream f;
+    writeWord(f, payload.size());
+    f.write(payload.data(), payload.size());
+    writeWord(f, crc32(payload));
+
+    return f.str();
+  }
+
+  // Read the frame at "pos" (and advance past it), unless it is incomplete or corrupt.
+  static bool readFrame(const std::string &data, size_t &pos, std::string &payload) {
+    const size_t wordSize = sizeof(uint64_t);
+    if ((data.size() - pos) < wordSize) {
+      return false;
+    }
+    uint64_t size;
+    std::memcpy(&size, data.data() + pos, wordSize);
+    if (size > (data.size() - pos - wordSize) || ((data.size() - pos - wordSize - size) < wordSize)) {
+      return false;
+    }
+    payload = data.substr(pos + wordSize, size);
+    uint64_t crc;
+    std::memcpy(&crc, data.data() + pos + wordSize + size, wordSize);
+    if (crc != crc32(payload)) {
+      return false;
+    }
+    pos += wordSize + size + wordSize;
+
+    return true;
+  }
+
+  void enqueue(const std::string &payload) {
+    const std::string f = frame(payload);
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+      queue.push_back(f);
+    }
+    queueCv.notify_one();
+  }
+
+  void writeFrames() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+      queueCv.wait(lock, [this] { return isStopping || !queue.empty(); });
+      std::vector<std::string> frames;
+      frames.swap(queue);
+      const bool isLast = isStopping;
+      lock.unlock();
+      for (const std::string &f : frames) {
+        out.write(f.data(), f.size());
+      }
+      out.flush();
+      lock.lock();
+      if (isLast && queue.empty()) {
+        return;
+      }
+    }
+  }
+};
+
 struct Factorizer {
   std::mutex batchMutex;
+  std::condition_variable relationCv;
   BigInteger toFactor;
   BigInteger toFactorSqrt;
   BigInteger qsBackwardLowBound;
@@ -376,7 +1073,12 @@ struct Factorizer {
   BigInteger smoothWheelRadius;
   size_t wheelEntryCount;
   size_t rowLimit;
+  size_t matrixMemoryLimit;
   bool isIncomplete;
+  bool isSieving;
+  // Relations come from CFRAC (key^2 mod N), rather than the sieve (key^2 - N).
+  bool isCfrac;
+  RelationLog *relationLog;
   std::vector<size_t> smoothPrimes;
   std::vector<BigInteger> smoothNumberKeys;
   std::vector<boost::dynamic_bitset<size_t>> smoothNumberValues;
@@ -384,9 +1086,9 @@ struct Factorizer {
   ForwardFn backwardFn;
 
   Factorizer(const BigInteger &tf, const BigInteger &tfsqrt, const BigInteger &lb, const BigInteger &range, size_t nodeCount, size_t nodeId, size_t w, size_t rl, const BigInteger& bn,
-             const std::vector<size_t> &sp, ForwardFn ffn, ForwardFn bfn)
+             const std::vector<size_t> &sp, ForwardFn ffn, ForwardFn bfn, size_t mml)
     : toFactor(tf), toFactorSqrt(tfsqrt), qsBackwardLowBound(lb), batchRange(range), batchNumber(bn), batchOffset(nodeId * range), batchTotal(nodeCount * range),
-    smoothWheelRadius(1U), wheelEntryCount(w), rowLimit(rl), isIncomplete(true), smoothPrimes(sp), forwardFn(ffn), backwardFn(bfn)
+    smoothWheelRadius(1U), wheelEntryCount(w), rowLimit(rl), matrixMemoryLimit(mml), isIncomplete(true), isSieving(true), isCfrac(false), relationLog(nullptr), smoothPrimes(sp), forwardFn(ffn), backwardFn(bfn)
   {
     smoothNumberKeys.reserve(rowLimit);
     smoothNumberValues.reserve(rowLimit);
@@ -489,6 +1191,11 @@ struct Factorizer {
 
         std::lock_guard<std::mutex> lock(batchMutex);
 
+        // The incremental eliminator might have found a factor already.
+        if (!isSieving) {
+          return 1U;
+        }
+
         std::cout << x << ", ";
 
         const auto& snvIt = std::find(smoothNumberValues.begin(), smoothNumberValues.end(), rfv);
@@ -497,6 +1204,10 @@ struct Factorizer {
           // This is a unique factorization parity row.
           smoothNumberValues.push_back(rfv);
           smoothNumberKeys.push_back(x);
+          relationCv.notify_one();
+          if (relationLog) {
+            relationLog->appendRelation(x, rfv);
+          }
           // If we have enough rows for Gaussian elimination already,
           // there's no reason to sieve any further.
           if (smoothNumberKeys.size() > rowLimit) {
@@ -506,9 +1217,11 @@ struct Factorizer {
           }
         } else {
           // Don't add this duplicate row, but check the square residue.
+          // The product of two residues with the same parity is a perfect square.
           // x^2 % toFactor = y^2
-          const BigInteger _x = x * smoothNumberKeys[std::distance(smoothNumberValues.begin(), snvIt)];
-          const BigInteger y = sqrt((_x * _x) % toFactor);
+          const BigInteger &x2 = smoothNumberKeys[std::distance(smoothNumberValues.begin(), snvIt)];
+          const BigInteger _x = (x * x2) % toFactor;
+          const BigInteger y = sqrt(ySqr * ((x2 * x2) - toFactor)) % toFactor;
 
           // Check x + y
           BigInteger factor = gcd(toFactor, _x + y);
@@ -521,7 +1234,7 @@ struct Factorizer {
           // Avoid division by 0
           if (_x != y) {
             // Check x - y
-            factor = gcd(toFactor, _x - y);
+            factor = gcd(toFactor, (_x > y) ? (_x - y) : (y - _x));
             if ((factor != 1U) && (factor != toFactor)) {
               isIncomplete = false;
 
@@ -533,126 +1246,228 @@ struct Factorizer {
         // We must manually increment on exiting the loop body.
         // batchItem += GetGearIncrement(inc_seqs);
       }
+
+      if (relationLog) {
+        // Every relation in this batch is logged already, so a resumed run can skip it.
+        relationLog->appendBatchDone((size_t)(batchNum - batchOffset));
+      }
     }
 
     return 1U;
   }
 
-  std::vector<std::vector<size_t>> extractSolutionRows(const boost::dynamic_bitset<size_t>& marks) {
-    std::vector<std::vector<size_t>> solutions;
-
-    for (size_t col = 0U; col < marks.size(); ++col) {
-      if (marks.test(col)) {
-        // Skip pivot columns
-        continue;
+  // Continued fraction factorization (CFRAC): a stream expands sqrt(kN), for k = m^2, and at every even index n,
+  // A_(n-1)^2 = Q_n (mod N), with Q_n < 2 sqrt(kN). Smooth Q_n are relations, just like smooth x^2 - N from the sieve.
+  // (With k a square, kN has the same quadratic residues as N, so the factor base is the sieve's.)
+  // Streams are handed out like sieving batches, with m = 1 + nodeId + nodeCount * (stream index), so nodes never overlap.
+  BigInteger cfracStreams() {
+    const BigInteger nodeId = batchOffset / batchRange;
+    const BigInteger nodeCount = batchTotal / batchRange;
+    for (BigInteger stream = getNextBatch() - batchOffset; isIncomplete; stream = getNextBatch() - batchOffset) {
+      const BigInteger m = 1U + nodeId + nodeCount * stream;
+      const BigInteger kN = m * m * toFactor;
+      const BigInteger g = sqrt(kN);
+      // P_1, Q_1, and Q_0
+      BigInteger p = g;
+      BigInteger q = kN - g * g;
+      BigInteger qPrev = 1U;
+      // A_0 and A_(-1) (mod N)
+      BigInteger a = g % toFactor;
+      BigInteger aPrev = 1U;
+      for (size_t n = 1U; isIncomplete; ++n) {
+        if (!(n & 1U)) {
+          // Q_n = 1 ends the period of the expansion, and it would only repeat from here.
+          if (q == 1U) {
+            break;
+          }
+          const BigInteger factor = addCfracRelation(a, q);
+          if (factor != 1U) {
+            return factor;
+          }
+        }
+        // a_n, then P_(n+1), Q_(n+1), and A_n
+        const BigInteger b = (g + p) / q;
+        const BigInteger pNext = b * q - p;
+        const BigInteger qNext = qPrev + b * (p - pNext);
+        p = pNext;
+        qPrev = q;
+        q = qNext;
+        const BigInteger aNext = (b * a + aPrev) % toFactor;
+        aPrev = a;
+        a = aNext;
       }
+    }
 
-      std::vector<size_t> selectedRows;
-      boost::dynamic_bitset<size_t> solutionRow(marks.size(), 0U);
+    return 1U;
+  }
+
+  // Record a CFRAC relation x^2 = residue (mod N), if the residue is smooth. Returns a factor, if one falls out directly, or else 1.
+  BigInteger addCfracRelation(const BigInteger &x, const BigInteger &residue) {
+    const boost::dynamic_bitset<size_t> rfv = factorizationParityVector(residue);
+    if (rfv.empty()) {
+      return 1U;
+    }
 
-      // Collect rows that have a 1 in this free column
-      for (size_t row = 0U; row < smoothNumberValues.size(); ++row) {
-        if (smoothNumberValues[row].test(col)) {
-          selectedRows.push_back(row);
-           // XOR to construct dependency
-          solutionRow ^= smoothNumberValues[row];
+    // The residue might be a perfect square already.
+    if (rfv.none()) {
+      const BigInteger y = sqrt(residue);
+      for (const BigInteger &s : {(BigInteger)(x + y), (BigInteger)((x > y) ? (x - y) : (y - x))}) {
+        const BigInteger factor = gcd(toFactor, s);
+        if ((factor != 1U) && (factor != toFactor)) {
+          isIncomplete = false;
+          return factor;
         }
       }
+    }
 
-      // Ensure the dependency is valid (all exponents must sum to even parity)
-      if (solutionRow.none()) {
-        solutions.push_back(selectedRows);
+    std::lock_guard<std::mutex> lock(batchMutex);
+
+    // The incremental eliminator might have found a factor already.
+    if (!isSieving || !isIncomplete) {
+      return 1U;
+    }
+
+    std::cout << x << ", ";
+
+    const auto &snvIt = std::find(smoothNumberValues.begin(), smoothNumberValues.end(), rfv);
+    if (snvIt == smoothNumberValues.end()) {
+      smoothNumberValues.push_back(rfv);
+      smoothNumberKeys.push_back(x);
+      relationCv.notify_one();
+      if (smoothNumberKeys.size() > rowLimit) {
+        isIncomplete = false;
+      }
+
+      return 1U;
+    }
+
+    // The product of two residues with the same parity is a perfect square.
+    const BigInteger &x2 = smoothNumberKeys[std::distance(smoothNumberValues.begin(), snvIt)];
+    const BigInteger _x = (x * x2) % toFactor;
+    const BigInteger y = sqrt(residue * smoothResidue(x2)) % toFactor;
+    for (const BigInteger &s : {(BigInteger)(_x + y), (BigInteger)((_x > y) ? (_x - y) : (y - _x))}) {
+      const BigInteger factor = gcd(toFactor, s);
+      if ((factor != 1U) && (factor != toFactor)) {
+        isIncomplete = false;
+        return factor;
       }
     }
 
-    return solutions;
+    return 1U;
   }
 
+  // The smooth residue that a relation's key squares to (mod N)
+  BigInteger smoothResidue(const BigInteger &key) const { return isCfrac ? (BigInteger)((key * key) % toFactor) : (BigInteger)((key * key) - toFactor); }
+
   // Perform Gaussian elimination on a binary matrix
-  std::vector<std::vector<size_t>> gaussianElimination() {
-    const size_t rows = smoothNumberValues.size();
-    boost::dynamic_bitset<size_t> marks(smoothPrimes.size(), 0U);
-    for (size_t col = 0U; col < smoothPrimes.size(); ++col) {
+  std::vector<std::vector<size_t>> gaussianElimination(const FilteredRelations &relations) {
+    // The filtered rows are left intact, so that row indices stay aligned with their member relations.
+    std::vector<boost::dynamic_bitset<size_t>> matrix(relations.rows);
+    const size_t rows = matrix.size();
+    // Each row tracks which of the original relations have been XOR-ed into it.
+    std::vector<boost::dynamic_bitset<size_t>> history(rows, boost::dynamic_bitset<size_t>(rows, 0U));
+    for (size_t row = 0U; row < rows; ++row) {
+      history[row].set(row);
+    }
+
+    size_t rank = 0U;
+    for (size_t col = 0U; (col < relations.columnCount) && (rank < rows); ++col) {
       // Look for a pivot row in this column
-      size_t row = col;
+      size_t row = rank;
       for (; row < rows; ++row) {
-        if (smoothNumberValues[row][col]) {
+        if (matrix[row][col]) {
           // Make sure the rows are in reduced row echelon order.
-          if (row != col) {
-            std::swap(smoothNumberKeys[row], smoothNumberKeys[col]);
-            std::swap(smoothNumberValues[row], smoothNumberValues[col]);
+          if (row != rank) {
+            std::swap(matrix[row], matrix[rank]);
+            std::swap(history[row], history[rank]);
           }
-
-          // Mark this column as having a pivot.
-          marks.set(col);
           break;
         }
       }
 
-      if ((col < smoothPrimes.size()) && marks[col]) {
-        // Row might have been swapped.
-        const boost::dynamic_bitset<size_t> &cm = smoothNumberValues[col];
-        // Pivot found, now eliminate entries in this column
-        const size_t maxLcv = std::min((size_t)CpuCount, rows);
-        for (size_t cpu = 0U; cpu < maxLcv; ++cpu) {
-          dispatch.dispatch([this, cpu, &col, &rows, &cm]() -> bool {
-            // Notice that each thread updates rows with space increments of cpuCount,
-            // based on the same unchanged outer-loop row, and this covers the inner-loop set.
-            // We're covering every row except for the one corresponding to "col."
-            // We break this into two loops to avoid an inner conditional to check whether row == col.
-            const size_t midRow = std::min(col, rows);
-            size_t irow = cpu;
-            for (; irow < midRow; irow += CpuCount) {
-              boost::dynamic_bitset<size_t> &rm = this->smoothNumberValues[irow];
-              if (rm.test(col)) {
-                // XOR-ing factorization rows
-                // is like multiplying the numbers.
-                rm ^= cm;
-              }
-            }
-            if (irow == col) {
-              irow += CpuCount;
+      if (row == rows) {
+        // No pivot in this column
+        continue;
+      }
+
+      // Row might have been swapped.
+      const size_t pivot = rank++;
+      const boost::dynamic_bitset<size_t> &cm = matrix[pivot];
+      const boost::dynamic_bitset<size_t> &ch = history[pivot];
+      // Pivot found, now eliminate entries in this column
+      const size_t maxLcv = std::min((size_t)CpuCount, rows);
+      for (size_t cpu = 0U; cpu < maxLcv; ++cpu) {
+        dispatch.dispatch([cpu, col, rows, pivot, &matrix, &history, &cm, &ch]() -> bool {
+          // Notice that each thread updates rows with space increments of cpuCount,
+          // based on the same unchanged outer-loop row, and this covers the inner-loop set.
+          // We're covering every row except for the pivot.
+          for (size_t irow = cpu; irow < rows; irow += CpuCount) {
+            if (irow == pivot) {
+              continue;
             }
-            for (; irow < rows; irow += CpuCount) {
-              boost::dynamic_bitset<size_t> &rm = this->smoothNumberValues[irow];
-              if (rm.test(col)) {
-                // XOR-ing factorization rows
-                // is like multiplying the numbers.
-                rm ^= cm;
-              }
+            boost::dynamic_bitset<size_t> &rm = matrix[irow];
+            if (rm.test(col)) {
+              // XOR-ing factorization rows
+              // is like multiplying the numbers.
+              rm ^= cm;
+              history[irow] ^= ch;
             }
+          }
 
-            return false;
-          });
-        }
-        // All dispatched work must complete.
-        dispatch.finish();
+          return false;
+        });
       }
+      // All dispatched work must complete.
+      dispatch.finish();
+    }
+
+    // Every row below the rank has been eliminated to zero,
+    // so the relations that were combined into it multiply to a perfect square.
+    std::vector<std::vector<size_t>> solutions;
+    for (size_t row = rank; row < rows; ++row) {
+      std::vector<size_t> selectedRows;
+      const boost::dynamic_bitset<size_t> &h = history[row];
+      for (size_t i = h.find_first(); i != boost::dynamic_bitset<size_t>::npos; i = h.find_next(i)) {
+        selectedRows.push_back(i);
+      }
+      solutions.push_back(selectedRows);
     }
 
-    const std::vector<std::vector<size_t>> solutions = extractSolutionRows(marks);
-
     if (solutions.empty()) {
-      throw std::runtime_error("Gaussian elimination found no solution (with rank " + std::to_string(smoothPrimes.size()) + "). If your rank is very low, consider increasing the smoothness bound. Otherwise, produce and retain more smooth numbers.");
+      throw std::runtime_error("Gaussian elimination found no solution (with rank " + std::to_string(relations.columnCount) + "). If your rank is very low, consider increasing the smoothness bound. Otherwise, produce and retain more smooth numbers.");
     }
 
     return solutions;
   }
 
-  BigInteger solveCongruence(const std::vector<size_t>& solutionVec)
+  // If "cancelled" is set by another thread, this gives up early (and returns 1).
+  BigInteger solveCongruence(const std::vector<size_t>& solutionVec, const std::atomic<bool> *cancelled = nullptr)
   {
     // x^2 % toFactor = y^2
     BigInteger x = 1U;
+    // The product of the residues is a perfect square,
+    // so its square root has half of every (even) prime exponent.
+    std::vector<size_t> exponents(smoothPrimes.size(), 0U);
     for (const size_t& idx : solutionVec) {
-      x *= smoothNumberKeys[idx];
+      if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+        return 1U;
+      }
+      const BigInteger &key = smoothNumberKeys[idx];
+      x = (x * key) % toFactor;
+      factorizationExponents(smoothResidue(key), exponents);
+    }
+    BigInteger y = 1U;
+    for (size_t pid = 0U; pid < smoothPrimes.size(); ++pid) {
+      if (exponents[pid]) {
+        y = (y * mod_exp(smoothPrimes[pid], exponents[pid] >> 1U, toFactor)) % toFactor;
+      }
     }
-    const BigInteger y = sqrt((x * x) % toFactor);
     // The WHOLE point of EVERYTHING we've done
     // is to guarantee this condition NEVER throws.
     // If we're finding solutions with the right
     // frequency as a function of rows saved,
     // we've correctly executed Quadratic Sieve.
-    if ((y * y) != ((x * x) % toFactor)) {
+    if (((y * y) % toFactor) != ((x * x) % toFactor)) {
       throw std::runtime_error("Quadratic Sieve math is not self-consistent!");
     }
 
@@ -662,212 +1477,3612 @@ struct Factorizer {
       return factor;
     }
 
-    // Avoid division by 0
-    if (x != y) {
-      // Check x - y
-      return gcd(toFactor, x - y);
-    }
+    // Avoid division by 0
+    if (x != y) {
+      // Check x - y
+      return gcd(toFactor, (x > y) ? (x - y) : (y - x));
+    }
+
+    return 1U;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  //                              WRITTEN WITH HELP FROM ELARA (GPT) ABOVE                                  //
+  ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  // Incremental (online) elimination, alongside sieving: every new relation is reduced against the pivots found so far,
+  // (each pivot row's lowest set bit is its pivot column,) and the first relations to reduce to zero are tried at once.
+  // This returns as soon as a congruence of squares gives a factor, or else when sieving stops.
+  BigInteger eliminateOnline() {
+    const size_t historySize = rowLimit + 1U;
+    std::vector<boost::dynamic_bitset<size_t>> pivotRows;
+    std::vector<boost::dynamic_bitset<size_t>> pivotHistory;
+    std::vector<size_t> pivotOfColumn(smoothPrimes.size(), (size_t)-1);
+    size_t next = 0U;
+    while (true) {
+      boost::dynamic_bitset<size_t> row;
+      {
+        std::unique_lock<std::mutex> lock(batchMutex);
+        relationCv.wait(lock, [this, next] { return !isSieving || (next < smoothNumberValues.size()); });
+        if (!isSieving) {
+          // Whatever is left goes to the usual (offline) solver.
+          return 1U;
+        }
+        row = smoothNumberValues[next];
+      }
+      boost::dynamic_bitset<size_t> history(historySize, 0U);
+      history.set(next++);
+
+      size_t col = row.find_first();
+      while ((col != boost::dynamic_bitset<size_t>::npos) && (pivotOfColumn[col] != (size_t)-1)) {
+        // XOR-ing clears this column, and it can only change columns after it.
+        row ^= pivotRows[pivotOfColumn[col]];
+        history ^= pivotHistory[pivotOfColumn[col]];
+        col = row.find_next(col);
+      }
+
+      if (col != boost::dynamic_bitset<size_t>::npos) {
+        pivotOfColumn[col] = pivotRows.size();
+        pivotRows.push_back(row);
+        pivotHistory.push_back(history);
+        continue;
+      }
+
+      // The relation reduced to zero, so its history is a dependency.
+      std::vector<size_t> selectedRows;
+      for (size_t i = history.find_first(); i != boost::dynamic_bitset<size_t>::npos; i = history.find_next(i)) {
+        selectedRows.push_back(i);
+      }
+      // (Sieving threads can grow the relation store, so hold the lock while reading it.)
+      std::lock_guard<std::mutex> lock(batchMutex);
+      const BigInteger factor = solveCongruence(selectedRows);
+      if ((factor != 1U) && (factor != toFactor)) {
+        isIncomplete = false;
+        isSieving = false;
+
+        return factor;
+      }
+    }
+  }
+
+  // Keep every relation, and resume sieving from the next unclaimed batch, until there are "moreRows" more.
+  // (This is false if the sieving range is already exhausted.)
+  bool resumeSieving(size_t moreRows) {
+    if (batchNumber >= batchRange) {
+      return false;
+    }
+    rowLimit += moreRows;
+    isIncomplete = true;
+    isSieving = true;
+
+    return true;
+  }
+
+  // Let the incremental eliminator know that no more relations are coming.
+  void stopSieving() {
+    std::lock_guard<std::mutex> lock(batchMutex);
+    isSieving = false;
+    relationCv.notify_all();
+  }
+
+  // Out-of-core Gaussian elimination: the augmented matrix [relations | history] lives in a memory-mapped scratch file,
+  // and it is eliminated one panel of rows at a time, so only about two panels need to be resident at once.
+  // Each panel is reduced by the pivots of every earlier panel (streamed through in order), then within itself.
+  std::vector<std::vector<size_t>> panelElimination(const FilteredRelations &relations, size_t memoryLimit) {
+    const size_t rows = relations.rows.size();
+    if (!rows) {
+      throw std::runtime_error("Gaussian elimination found no solution (with rank 0). Produce and retain more smooth numbers.");
+    }
+    const size_t columnWords = (relations.columnCount + 63U) >> 6U;
+    const size_t width = columnWords + ((rows + 63U) >> 6U);
+    const size_t rowBytes = width * sizeof(uint64_t);
+    // The current panel and one earlier panel share the memory limit.
+    const size_t panelRows = std::max((size_t)1U, memoryLimit / (rowBytes << 1U));
+    MappedFile file(rows * rowBytes);
+    uint64_t *words = file.words();
+
+    // The new file is zero-filled, so only set bits need to be written.
+    for (size_t p0 = 0U; p0 < rows; p0 += panelRows) {
+      const size_t p1 = std::min(rows, p0 + panelRows);
+      for (size_t row = p0; row < p1; ++row) {
+        uint64_t *rw = words + row * width;
+        const boost::dynamic_bitset<size_t> &rfv = relations.rows[row];
+        for (size_t col = rfv.find_first(); col != boost::dynamic_bitset<size_t>::npos; col = rfv.find_next(col)) {
+          rw[col >> 6U] |= 1ULL << (col & 63U);
+        }
+        rw[columnWords + (row >> 6U)] |= 1ULL << (row & 63U);
+      }
+      file.release(p0 * rowBytes, (p1 - p0) * rowBytes);
+    }
+
+    const size_t noPivot = (size_t)-1;
+    std::vector<size_t> pivots(rows, noPivot);
+    std::vector<std::vector<size_t>> solutions;
+    for (size_t p0 = 0U; p0 < rows; p0 += panelRows) {
+      const size_t p1 = std::min(rows, p0 + panelRows);
+      file.prefetch(p0 * rowBytes, (p1 - p0) * rowBytes);
+
+      // Every earlier pivot row is already zero in all earlier pivot columns,
+      // so applying them in the order they were found clears every one of those columns.
+      for (size_t q0 = 0U; q0 < p0; q0 += panelRows) {
+        const size_t q1 = q0 + panelRows;
+        file.prefetch(q0 * rowBytes, panelRows * rowBytes);
+        const size_t maxLcv = std::min((size_t)CpuCount, p1 - p0);
+        for (size_t cpu = 0U; cpu < maxLcv; ++cpu) {
+          dispatch.dispatch([cpu, p0, p1, q0, q1, width, words, noPivot, &pivots]() -> bool {
+            for (size_t row = p0 + cpu; row < p1; row += CpuCount) {
+              uint64_t *rw = words + row * width;
+              for (size_t pr = q0; pr < q1; ++pr) {
+                const size_t &col = pivots[pr];
+                if ((col == noPivot) || !((rw[col >> 6U] >> (col & 63U)) & 1U)) {
+                  continue;
+                }
+                const uint64_t *pw = words + pr * width;
+                for (size_t i = 0U; i < width; ++i) {
+                  rw[i] ^= pw[i];
+                }
+              }
+            }
+
+            return false;
+          });
+        }
+        dispatch.finish();
+        file.release(q0 * rowBytes, panelRows * rowBytes);
+      }
+
+      // Within the panel, every new pivot is eliminated from the rows after it.
+      for (size_t row = p0; row < p1; ++row) {
+        const uint64_t *rw = words + row * width;
+        size_t col = noPivot;
+        for (size_t i = 0U; i < columnWords; ++i) {
+          if (rw[i]) {
+            size_t b = 0U;
+            while (!((rw[i] >> b) & 1U)) {
+              ++b;
+            }
+            col = (i << 6U) | b;
+            break;
+          }
+        }
+
+        if (col == noPivot) {
+          // The row was eliminated to zero, so its history is a dependency.
+          std::vector<size_t> selectedRows;
+          for (size_t i = columnWords; i < width; ++i) {
+            for (size_t b = 0U; b < 64U; ++b) {
+              if ((rw[i] >> b) & 1U) {
+                selectedRows.push_back(((i - columnWords) << 6U) | b);
+              }
+            }
+          }
+          solutions.push_back(selectedRows);
+          continue;
+        }
+
+        pivots[row] = col;
+        const size_t maxLcv = std::min((size_t)CpuCount, p1 - (row + 1U));
+        for (size_t cpu = 0U; cpu < maxLcv; ++cpu) {
+          dispatch.dispatch([cpu, row, col, p1, width, words, rw]() -> bool {
+            for (size_t irow = row + 1U + cpu; irow < p1; irow += CpuCount) {
+              uint64_t *iw = words + irow * width;
+              if ((iw[col >> 6U] >> (col & 63U)) & 1U) {
+                for (size_t i = 0U; i < width; ++i) {
+                  iw[i] ^= rw[i];
+                }
+              }
+            }
+
+            return false;
+          });
+        }
+        dispatch.finish();
+      }
+      file.release(p0 * rowBytes, (p1 - p0) * rowBytes);
+    }
+
+    if (solutions.empty()) {
+      throw std::runtime_error("Gaussian elimination found no solution (with rank " + std::to_string(relations.columnCount) + "). If your rank is very low, consider increasing the smoothness bound. Otherwise, produce and retain more smooth numbers.");
+    }
+
+    return solutions;
+  }
+
+  // Find up to 64 dependencies at once with (Montgomery's) Block Lanczos over GF(2).
+  // The symmetric operator M * M^T is only ever applied as two sparse products,
+  // so memory scales with the count of nonzero matrix entries, rather than its area.
+  std::vector<std::vector<size_t>> blockLanczos(const FilteredRelations &relations) {
+    const SparseParityMatrix matrix(relations.rows, relations.columnCount);
+    const size_t n = matrix.rowCount();
+    std::vector<std::vector<BlockWord>> scratch;
+    std::vector<BlockWord> tmp;
+    std::mt19937_64 rng(std::random_device{}());
+
+    // Lanczos can (rarely) break down for an unlucky random start.
+    for (size_t attempt = 0U; attempt < 3U; ++attempt) {
+      // Solve A * x = A * y for random y, so x + y will be in the null space of A.
+      std::vector<BlockWord> y(n);
+      for (BlockWord &w : y) {
+        w = rng();
+      }
+      std::vector<BlockWord> v[3U] = {std::vector<BlockWord>(n, 0U), std::vector<BlockWord>(n, 0U), std::vector<BlockWord>(n, 0U)};
+      std::vector<BlockWord> x(n, 0U);
+      std::vector<BlockWord> vNext;
+      matrix.multiplySymmetric(y, v[0U], tmp, scratch);
+      const std::vector<BlockWord> v0(v[0U]);
+
+      BlockWord wInv[3U][64U] = {};
+      BlockWord vtav[2U][64U] = {};
+      BlockWord vta2v[2U][64U] = {};
+      BlockWord vtv0[64U], d[64U], e[64U], f[64U], f2[64U];
+      size_t s[2U][64U];
+      std::iota(s[1U], s[1U] + 64U, 0U);
+      size_t dim1 = 64U;
+      BlockWord mask1 = ~0ULL;
+      // Each iteration solves for (nearly) 64 dimensions.
+      const size_t maxIteration = n / 60U + 16U;
+      bool isFailed = false;
+      for (size_t iteration = 0U; ; ++iteration) {
+        if (iteration > maxIteration) {
+          isFailed = true;
+          break;
+        }
+
+        // v^T * A * v and (A * v)^T * (A * v)
+        matrix.multiplySymmetric(v[0U], vNext, tmp, scratch);
+        mul64xNx64(v[0U], vNext, vtav[0U]);
+        mul64xNx64(vNext, vNext, vta2v[0U]);
+        // If the former is orthogonal to itself, the iteration has finished.
+        if (std::all_of(vtav[0U], vtav[0U] + 64U, [](const BlockWord &w) { return !w; })) {
+          break;
+        }
+
+        const size_t dim0 = findNonsingularSub(vtav[0U], s[0U], s[1U], dim1, wInv[0U]);
+        if (!dim0) {
+          break;
+        }
+        BlockWord mask0 = 0U;
+        for (size_t i = 0U; i < dim0; ++i) {
+          mask0 |= 1ULL << s[0U][i];
+        }
+        // Every column must be selected in the current and/or the previous iteration.
+        if ((mask0 | mask1) != ~0ULL) {
+          isFailed = true;
+          break;
+        }
+        if (mask0 != ~0ULL) {
+          for (BlockWord &w : vNext) {
+            w &= mask0;
+          }
+        }
+
+        // x += v * wInv * (v^T * v0)
+        mul64xNx64(v[0U], v0, vtv0);
+        mul64x64(wInv[0U], vtv0, d);
+        mulNx64x64Acc(v[0U], d, x);
+
+        // The three-term recurrence for the next v:
+        // vNext = A * v * S * S^T + v * D + vPrev * E + vPrevPrev * F
+        for (size_t i = 0U; i < 64U; ++i) {
+          d[i] = (vta2v[0U][i] & mask0) ^ vtav[0U][i];
+        }
+        mul64x64(wInv[0U], d, d);
+        for (size_t i = 0U; i < 64U; ++i) {
+          d[i] ^= 1ULL << i;
+        }
+        mulNx64x64Acc(v[0U], d, vNext);
+
+        mul64x64(wInv[1U], vtav[0U], e);
+        for (size_t i = 0U; i < 64U; ++i) {
+          e[i] &= mask0;
+        }
+        mulNx64x64Acc(v[1U], e, vNext);
+
+        // F vanishes if every column was selected on the previous iteration.
+        if (mask1 != ~0ULL) {
+          mul64x64(vtav[1U], wInv[1U], f);
+          for (size_t i = 0U; i < 64U; ++i) {
+            f[i] ^= 1ULL << i;
+          }
+          mul64x64(wInv[2U], f, f);
+          for (size_t i = 0U; i < 64U; ++i) {
+            f2[i] = ((vta2v[1U][i] & mask1) ^ vtav[1U][i]) & mask0;
+          }
+          mul64x64(f, f2, f);
+          mulNx64x64Acc(v[2U], f, vNext);
+        }
+
+        v[2U].swap(v[1U]);
+        v[1U].swap(v[0U]);
+        v[0U].swap(vNext);
+        std::copy(wInv[1U], wInv[1U] + 64U, wInv[2U]);
+        std::copy(wInv[0U], wInv[0U] + 64U, wInv[1U]);
+        std::copy(vtav[0U], vtav[0U] + 64U, vtav[1U]);
+        std::copy(vta2v[0U], vta2v[0U] + 64U, vta2v[1U]);
+        std::copy(s[0U], s[0U] + dim0, s[1U]);
+        dim1 = dim0;
+        mask1 = mask0;
+      }
+
+      if (isFailed) {
+        continue;
+      }
+
+      // A * (x + y) is (nearly) 0, but we need M^T * (x + y) to be exactly 0.
+      // Combine the 128 columns of [x + y | v] so that M^T annihilates them.
+      for (size_t i = 0U; i < n; ++i) {
+        x[i] ^= y[i];
+      }
+      std::vector<BlockWord> ux, uv;
+      matrix.multiplyTransposed(x, ux, scratch);
+      matrix.multiplyTransposed(v[0U], uv, scratch);
+
+      // Reduced row echelon basis for the row space of [ux | uv]
+      BlockWord basis[128U][2U];
+      size_t pivots[128U];
+      size_t rank = 0U;
+      const auto testBit = [](const BlockWord *r, size_t c) { return (bool)((r[c >> 6U] >> (c & 63U)) & 1U); };
+      for (size_t pid = 0U; (pid < ux.size()) && (rank < 128U); ++pid) {
+        BlockWord r[2U] = {ux[pid], uv[pid]};
+        for (size_t k = 0U; k < rank; ++k) {
+          if (testBit(r, pivots[k])) {
+            r[0U] ^= basis[k][0U];
+            r[1U] ^= basis[k][1U];
+          }
+        }
+        if (!r[0U] && !r[1U]) {
+          continue;
+        }
+        size_t c = 0U;
+        while (!testBit(r, c)) {
+          ++c;
+        }
+        for (size_t k = 0U; k < rank; ++k) {
+          if (testBit(basis[k], c)) {
+            basis[k][0U] ^= r[0U];
+            basis[k][1U] ^= r[1U];
+          }
+        }
+        basis[rank][0U] = r[0U];
+        basis[rank][1U] = r[1U];
+        pivots[rank++] = c;
+      }
+
+      // Every free column gives a null space combination.
+      BlockWord zx[64U] = {}, zv[64U] = {};
+      size_t nullCount = 0U;
+      for (size_t c = 0U; (c < 128U) && (nullCount < 64U); ++c) {
+        if (std::find(pivots, pivots + rank, c) != (pivots + rank)) {
+          continue;
+        }
+        BlockWord z[2U] = {0U, 0U};
+        z[c >> 6U] |= 1ULL << (c & 63U);
+        for (size_t k = 0U; k < rank; ++k) {
+          if (testBit(basis[k], c)) {
+            z[pivots[k] >> 6U] |= 1ULL << (pivots[k] & 63U);
+          }
+        }
+        // As the 64x64 matrices that map [x + y | v] onto the null space block:
+        for (size_t j = 0U; j < 64U; ++j) {
+          zx[j] |= ((z[0U] >> j) & 1U) << nullCount;
+          zv[j] |= ((z[1U] >> j) & 1U) << nullCount;
+        }
+        ++nullCount;
+      }
+
+      std::vector<BlockWord> kernel(n, 0U);
+      mulNx64x64Acc(x, zx, kernel);
+      mulNx64x64Acc(v[0U], zv, kernel);
+
+      // Double-check every dependency, and discard the empty ones.
+      std::vector<BlockWord> check;
+      matrix.multiplyTransposed(kernel, check, scratch);
+      BlockWord badMask = 0U, nonzeroMask = 0U;
+      for (const BlockWord &w : check) {
+        badMask |= w;
+      }
+      for (const BlockWord &w : kernel) {
+        nonzeroMask |= w;
+      }
+      const BlockWord goodMask = nonzeroMask & ~badMask;
+
+      std::vector<std::vector<size_t>> solutions;
+      for (size_t k = 0U; k < 64U; ++k) {
+        if (!((goodMask >> k) & 1U)) {
+          continue;
+        }
+        std::vector<size_t> selectedRows;
+        for (size_t row = 0U; row < n; ++row) {
+          if ((kernel[row] >> k) & 1U) {
+            selectedRows.push_back(row);
+          }
+        }
+        solutions.push_back(selectedRows);
+      }
+      std::sort(solutions.begin(), solutions.end());
+      solutions.erase(std::unique(solutions.begin(), solutions.end()), solutions.end());
+
+      if (!solutions.empty()) {
+        return solutions;
+      }
+    }
+
+    throw std::runtime_error("Block Lanczos found no solution (with rank " + std::to_string(relations.columnCount) + "). If your rank is very low, consider increasing the smoothness bound. Otherwise, produce and retain more smooth numbers.");
+  }
+
+  // Block Wiedemann works on the square operator A (see SparseParityMatrix::multiplyFolded()),
+  // with random blocks X (64 columns) and Y (64 columns per part) that every process derives from the same seed.
+  // Each part's share of the Krylov sequence, X^T * A^i * (A * Y_part), is independent of every other part,
+  // so parts can be computed by separate processes (or nodes) that only share the relation matrix file.
+  static size_t blockWiedemannLength(size_t rows, size_t partCount) {
+    const size_t width = partCount << 6U;
+    return ((rows + 63U) >> 6U) + ((rows + width - 1U) / width) + 16U;
+  }
+
+  static std::vector<BlockWord> blockWiedemannRandomBlock(size_t seed, size_t stream, size_t rows) {
+    std::mt19937_64 rng(seed + stream);
+    std::vector<BlockWord> block(rows);
+    for (BlockWord &w : block) {
+      w = rng();
+    }
+
+    return block;
+  }
+
+  // Word (i * 64 + j) of the output is column j of X^T * A^i * (A * Y_part), over the 64 columns of X.
+  std::vector<BlockWord> blockWiedemannPart(const FilteredRelations &relations, size_t seed, size_t partId, size_t partCount) {
+    const SparseParityMatrix matrix(relations.rows, relations.columnCount);
+    const size_t length = blockWiedemannLength(matrix.rowCount(), partCount);
+    const std::vector<BlockWord> x = blockWiedemannRandomBlock(seed, 0U, matrix.rowCount());
+    std::vector<std::vector<BlockWord>> scratch;
+    std::vector<BlockWord> z, next, tmp;
+    matrix.multiplyFolded(blockWiedemannRandomBlock(seed, partId + 1U, matrix.rowCount()), z, tmp, scratch);
+
+    std::vector<BlockWord> sequence(length << 6U);
+    for (size_t i = 0U; i < length; ++i) {
+      mul64xNx64(z, x, &(sequence[i << 6U]));
+      if ((i + 1U) < length) {
+        matrix.multiplyFolded(z, next, tmp, scratch);
+        z.swap(next);
+      }
+    }
+
+    return sequence;
+  }
+
+  // Combine the Krylov sequence parts into dependencies, with Coppersmith's block Berlekamp-Massey
+  // algorithm for a matrix generator, and then evaluate generator columns on the Y blocks.
+  std::vector<std::vector<size_t>> blockWiedemann(const FilteredRelations &relations, size_t seed, const std::vector<std::vector<BlockWord>> &parts) {
+    const SparseParityMatrix matrix(relations.rows, relations.columnCount);
+    const size_t n = matrix.rowCount();
+    const size_t partCount = parts.size();
+    const size_t width = partCount << 6U;
+    const size_t length = blockWiedemannLength(n, partCount);
+    for (const std::vector<BlockWord> &part : parts) {
+      if (part.size() != (length << 6U)) {
+        throw std::runtime_error("Block Wiedemann sequence part does not match the relation matrix!");
+      }
+    }
+    // Column j of sequence term a_i, over the 64 columns of X
+    const auto term = [&parts](size_t i, size_t j) -> BlockWord { return parts[j >> 6U][(i << 6U) | (j & 63U)]; };
+
+    // Start from 64 linearly independent sequence columns, so the first discrepancy has full rank.
+    std::vector<std::pair<size_t, size_t>> extra;
+    std::vector<BlockWord> basis;
+    size_t t0 = 1U;
+    for (size_t i = 0U; (i < length) && (extra.size() < 64U); ++i) {
+      for (size_t j = 0U; (j < width) && (extra.size() < 64U); ++j) {
+        BlockWord w = term(i, j);
+        for (const BlockWord &b : basis) {
+          w = std::min(w, w ^ b);
+        }
+        if (!w) {
+          continue;
+        }
+        basis.push_back(w);
+        std::sort(basis.begin(), basis.end(), std::greater<BlockWord>());
+        extra.emplace_back(i, j);
+        t0 = i + 1U;
+      }
+    }
+
+    // Every generator column holds a polynomial "gen" (one "partCount"-word vector per coefficient),
+    // its nominal degree, and the series "err" = A(X) * gen(X), for A(X) the sum of a_i * X^i.
+    // Coefficients [degree, t) of every series are kept at 0, as t advances.
+    const size_t colCount = width + extra.size();
+    std::vector<std::vector<BlockWord>> gen(colCount);
+    std::vector<std::vector<BlockWord>> err(colCount, std::vector<BlockWord>(length, 0U));
+    std::vector<size_t> degree(colCount, t0);
+    for (size_t c = 0U; c < width; ++c) {
+      gen[c].assign(partCount, 0U);
+      gen[c][c >> 6U] = 1ULL << (c & 63U);
+      for (size_t i = 0U; i < length; ++i) {
+        err[c][i] = term(i, c);
+      }
+    }
+    for (size_t r = 0U; r < extra.size(); ++r) {
+      const size_t c = width + r;
+      const size_t shift = t0 - extra[r].first;
+      const size_t j = extra[r].second;
+      gen[c].assign((shift + 1U) * partCount, 0U);
+      gen[c][shift * partCount + (j >> 6U)] = 1ULL << (j & 63U);
+      for (size_t i = shift; i < length; ++i) {
+        err[c][i] = term(i - shift, j);
+      }
+    }
+
+    std::vector<size_t> order(colCount);
+    std::iota(order.begin(), order.end(), 0U);
+    for (size_t t = t0; t < length; ++t) {
+      // Zero the discrepancy at t with column operations from lower toward higher degree.
+      std::stable_sort(order.begin(), order.end(), [&degree](const size_t &a, const size_t &b) { return degree[a] < degree[b]; });
+      std::vector<std::pair<size_t, size_t>> pivots;
+      for (const size_t &c : order) {
+        for (const std::pair<size_t, size_t> &pivot : pivots) {
+          if (!((err[c][t] >> pivot.first) & 1U)) {
+            continue;
+          }
+          const size_t &p = pivot.second;
+          if (gen[c].size() < gen[p].size()) {
+            gen[c].resize(gen[p].size(), 0U);
+          }
+          for (size_t i = 0U; i < gen[p].size(); ++i) {
+            gen[c][i] ^= gen[p][i];
+          }
+          for (size_t i = t; i < length; ++i) {
+            err[c][i] ^= err[p][i];
+          }
+        }
+        const BlockWord w = err[c][t];
+        if (w) {
+          size_t row = 0U;
+          while (!((w >> row) & 1U)) {
+            ++row;
+          }
+          pivots.emplace_back(row, c);
+        }
+      }
+      // The pivot columns are multiplied by X.
+      for (const std::pair<size_t, size_t> &pivot : pivots) {
+        const size_t &p = pivot.second;
+        gen[p].insert(gen[p].begin(), partCount, 0U);
+        err[p].insert(err[p].begin(), 0U);
+        err[p].pop_back();
+        ++degree[p];
+      }
+    }
+
+    // The lowest-degree columns are generator candidates, evaluated in batches of 64:
+    // for candidate "f" with (true) degree "d", v = sum(A^l * Y * f_(d - l)) should have A * (A * v) = 0.
+    std::stable_sort(order.begin(), order.end(), [&degree](const size_t &a, const size_t &b) { return degree[a] < degree[b]; });
+    std::vector<std::vector<BlockWord>> ys;
+    for (size_t part = 0U; part < partCount; ++part) {
+      ys.push_back(blockWiedemannRandomBlock(seed, part + 1U, n));
+    }
+    std::vector<std::vector<BlockWord>> scratch;
+    std::vector<BlockWord> tmp;
+    for (size_t batchStart = 0U; batchStart < width; batchStart += 64U) {
+      std::vector<size_t> candidates;
+      std::vector<size_t> trueDegrees;
+      size_t maxDegree = 0U, maxDeficit = 0U;
+      for (size_t b = batchStart; (b < width) && (b < (batchStart + 64U)); ++b) {
+        const size_t c = order[b];
+        std::vector<BlockWord> &f = gen[c];
+        while (!f.empty() && std::all_of(f.end() - partCount, f.end(), [](const BlockWord &w) { return !w; })) {
+          f.resize(f.size() - partCount);
+        }
+        if (f.empty()) {
+          continue;
+        }
+        const size_t d = f.size() / partCount - 1U;
+        candidates.push_back(c);
+        trueDegrees.push_back(d);
+        maxDegree = std::max(maxDegree, d);
+        maxDeficit = std::max(maxDeficit, degree[c] - d);
+      }
+
+      // Horner's method, over all candidates at once
+      std::vector<BlockWord> v(n, 0U), u;
+      for (size_t l = maxDegree + 1U; l-- > 0U;) {
+        if (l < maxDegree) {
+          matrix.multiplyFolded(v, u, tmp, scratch);
+          v.swap(u);
+        }
+        for (size_t part = 0U; part < partCount; ++part) {
+          BlockWord g[64U] = {};
+          for (size_t b = 0U; b < candidates.size(); ++b) {
+            if (l > trueDegrees[b]) {
+              continue;
+            }
+            const BlockWord w = gen[candidates[b]][(trueDegrees[b] - l) * partCount + part];
+            for (size_t j = 0U; j < 64U; ++j) {
+              g[j] |= ((w >> j) & 1U) << b;
+            }
+          }
+          mulNx64x64Acc(ys[part], g, v);
+        }
+      }
+
+      // Some power of A takes each candidate to a (nonzero) null space vector.
+      std::vector<BlockWord> kernel(n, 0U);
+      BlockWord found = 0U;
+      for (size_t power = 0U; power < (maxDeficit + 3U); ++power) {
+        BlockWord live = 0U;
+        for (const BlockWord &w : v) {
+          live |= w;
+        }
+        live &= ~found;
+        if (!live) {
+          break;
+        }
+        matrix.multiplyFolded(v, u, tmp, scratch);
+        BlockWord image = 0U;
+        for (const BlockWord &w : u) {
+          image |= w;
+        }
+        const BlockWord done = live & ~image;
+        for (size_t row = 0U; row < n; ++row) {
+          kernel[row] |= v[row] & done;
+        }
+        found |= done;
+        v.swap(u);
+      }
+
+      // A's null space could be larger than M^T's, if it was folded, so double-check.
+      std::vector<BlockWord> check;
+      matrix.multiplyTransposed(kernel, check, scratch);
+      BlockWord badMask = 0U;
+      for (const BlockWord &w : check) {
+        badMask |= w;
+      }
+      const BlockWord goodMask = found & ~badMask;
+
+      std::vector<std::vector<size_t>> solutions;
+      for (size_t k = 0U; k < 64U; ++k) {
+        if (!((goodMask >> k) & 1U)) {
+          continue;
+        }
+        std::vector<size_t> selectedRows;
+        for (size_t row = 0U; row < n; ++row) {
+          if ((kernel[row] >> k) & 1U) {
+            selectedRows.push_back(row);
+          }
+        }
+        solutions.push_back(selectedRows);
+      }
+      std::sort(solutions.begin(), solutions.end());
+      solutions.erase(std::unique(solutions.begin(), solutions.end()), solutions.end());
+
+      if (!solutions.empty()) {
+        return solutions;
+      }
+    }
+
+    throw std::runtime_error("Block Wiedemann found no solution (with rank " + std::to_string(relations.columnCount) + "). If your rank is very low, consider increasing the smoothness bound. Otherwise, produce and retain more smooth numbers.");
+  }
+
+  // The relation matrix file holds everything the linear algebra and square root steps need:
+  // the number to factor, a shared random seed, the factor base, and every relation's x and odd-exponent prime indices.
+  void writeRelationMatrix(const std::string &path, size_t seed) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error("Could not open relation matrix file for writing: " + path);
+    }
+    writeString(out, RelationMatrixMagic);
+    writeString(out, boost::lexical_cast<std::string>(toFactor));
+    writeWord(out, seed);
+    writeWord(out, smoothPrimes.size());
+    for (const size_t &p : smoothPrimes) {
+      writeWord(out, p);
+    }
+    writeWord(out, smoothNumberKeys.size());
+    for (size_t row = 0U; row < smoothNumberKeys.size(); ++row) {
+      writeString(out, boost::lexical_cast<std::string>(smoothNumberKeys[row]));
+      const boost::dynamic_bitset<size_t> &rfv = smoothNumberValues[row];
+      writeWord(out, rfv.count());
+      for (size_t pid = rfv.find_first(); pid != boost::dynamic_bitset<size_t>::npos; pid = rfv.find_next(pid)) {
+        writeWord(out, pid);
+      }
+    }
+    if (!out) {
+      throw std::runtime_error("Failed writing relation matrix file: " + path);
+    }
+  }
+
+  BigInteger solveForFactor() {
+    // Gaussian elimination is used to create a perfect square of the residues.
+    if (smoothNumberKeys.empty()) {
+        throw std::runtime_error("No smooth numbers found. Sieve more, or increase smoothness bound to reduce selectiveness. (The sieving bound multiplier is equivalent to that many times the square root of the number to factor, for calculated numerical range above an offset of the square root of the number to factor.)");
+    }
+
+    std::cout << std::endl;
+    std::cout << "Filtering relations..." << std::endl;
+    const FilteredRelations relations = filterRelations();
+    std::cout << "Filtered " << smoothNumberValues.size() << " x " << smoothPrimes.size() << " relation matrix to " << relations.rows.size() << " x " << relations.columnCount << "." << std::endl;
+
+    // Dense elimination is cubic in time and quadratic in memory, so large matrices go to Block Lanczos,
+    // unless a matrix memory limit is set, in which case dense elimination moves out of core past that limit.
+    const size_t rows = relations.rows.size();
+    const size_t denseBytes = rows * (((relations.columnCount + 63U) >> 6U) + ((rows + 63U) >> 6U)) * sizeof(uint64_t);
+    const bool isOutOfCore = matrixMemoryLimit && (denseBytes > matrixMemoryLimit);
+    const bool isSparse = !matrixMemoryLimit && (relations.columnCount > BlockLanczosThreshold);
+
+    if (isSparse) {
+      std::cout << "Performing Block Lanczos..." << std::endl;
+      return solveCongruences(relations.expand(blockLanczos(relations)));
+    }
+    if (isOutOfCore) {
+      std::cout << "Performing out-of-core Gaussian elimination..." << std::endl;
+      return solveCongruences(relations.expand(panelElimination(relations, matrixMemoryLimit)));
+    }
+    std::cout << "Performing Gaussian elimination..." << std::endl;
+
+    return solveCongruences(relations.expand(gaussianElimination(relations)));
+  }
+
+  // The requested surplus of rows over the factor base is kept through filtering.
+  FilteredRelations filterRelations() const {
+    const size_t surplus = (rowLimit > smoothPrimes.size()) ? (rowLimit - smoothPrimes.size()) : 0U;
+
+    return FilteredRelations(smoothNumberValues, smoothPrimes.size(), surplus);
+  }
+
+  // Try every dependency on the thread pool, until one gives a nontrivial factor.
+  // Threads claim dependencies one at a time, and the first factor found cancels the rest.
+  BigInteger solveCongruences(const std::vector<std::vector<size_t>> &solutions) {
+    std::atomic<bool> found(false);
+    std::atomic<size_t> next(0U);
+    BigInteger result = 1U;
+    std::exception_ptr error;
+    std::mutex resultMutex;
+    const size_t maxLcv = std::min((size_t)CpuCount, solutions.size());
+    for (size_t cpu = 0U; cpu < maxLcv; ++cpu) {
+      dispatch.dispatch([this, &solutions, &found, &next, &result, &error, &resultMutex]() -> bool {
+        // (Returning true would stop the dispatch queue for good, so cancellation is cooperative.)
+        try {
+          for (size_t i = next++; (i < solutions.size()) && !found.load(std::memory_order_relaxed); i = next++) {
+            const BigInteger factor = solveCongruence(solutions[i], &found);
+            if ((factor != 1U) && (factor != toFactor)) {
+              std::lock_guard<std::mutex> lock(resultMutex);
+              if (!found.exchange(true)) {
+                result = factor;
+              }
+            }
+          }
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(resultMutex);
+          error = std::current_exception();
+          found = true;
+        }
+
+        return false;
+      });
+    }
+    dispatch.finish();
+
+    if (result != 1U) {
+      return result;
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+
+    // Depending on row count, a successful result should be nearly guaranteed,
+    // but we default to no solution.
+    throw std::runtime_error("No solution produced a congruence of squares. (We found " + std::to_string(solutions.size()) + " solutions, and even 1 should often be enough.)");
+  }
+
+  // Accumulate the prime factorization exponents of a smooth residue
+  void factorizationExponents(BigInteger num, std::vector<size_t> &exponents) {
+    for (size_t pid = 0U; (pid < smoothPrimes.size()) && (num != 1U); ++pid) {
+      const size_t &p = smoothPrimes[pid];
+      while (!(num % p)) {
+        num /= p;
+        ++exponents[pid];
+      }
+    }
+    if (num != 1U) {
+      throw std::runtime_error("Quadratic Sieve relation is not smooth over the factor base!");
+    }
+  }
+
+  // Compute the prime factorization modulo 2
+  boost::dynamic_bitset<size_t> factorizationParityVector(BigInteger num) {
+    boost::dynamic_bitset<size_t> vec(smoothPrimes.size(), 0U);
+    std::vector<size_t> spids(smoothPrimes.size());
+    std::iota(spids.begin(), spids.end(), 0);
+    while (true) {
+      // Proceed in steps of the GCD with the smooth prime wheel radius.
+      BigInteger factor = gcd(num, smoothWheelRadius);
+      if (factor == 1U) {
+        break;
+      }
+      num /= factor;
+      // Remove smooth primes from factor.
+      // (The GCD is necessarily smooth.)
+      for (size_t pi = spids.size() - 1U; ; --pi) {
+        const size_t& pid = spids[pi];
+        const size_t& p = smoothPrimes[pid];
+        if (factor % p) {
+          // Once a preamble factor is found not to be present,
+          // there's no longer use trying for it on the next iteration.
+          spids.erase(spids.begin() + pi);
+          continue;
+        }
+        factor /= p;
+        vec.flip(pid);
+        if (factor == 1U) {
+          // The step is fully factored.
+          // (This case is always reached.)
+          spids.erase(spids.begin(), spids.begin() + pi);
+          break;
+        }
+      }
+      if (num == 1U) {
+        // The number is fully factored and smooth.
+        return vec;
+      }
+    }
+    if (num != 1U) {
+      // The number was not fully factored, because it is not smooth.
+      // We reject it as a sieving candidate.
+      return boost::dynamic_bitset<size_t>();
+    }
+
+    // This number is smooth, and we return its factorization parity.
+    return vec;
+  }
+};
+
+// Pollard's Rho factorization using Brent's improvement.
+// By (Anthropic) Claude
+//
+// Expected runtime O(n^(1/4)) — faster than trial division for
+// mid-range semiprimes, slower than Quadratic Sieve for large ones.
+// Fills the gap between wheel/gear trial division and QS.
+//
+// Brent's variant saves periodic "tortoise" checkpoints and batches
+// GCD computations (every `batchSize` steps), reducing GCD overhead
+// significantly vs. Floyd's cycle detection.
+//
+// Returns a non-trivial factor of n, or 1 if this attempt failed
+// (caller should retry with a different c), if "stop" was set
+// by another walk, or if the walk took more than maxIterations
+// steps (0 for no limit). (Both are checked once per GCD batch.)
+BigInteger pollardRhoBrent(const BigInteger& n, const BigInteger& c, const std::atomic<bool>& stop, size_t maxIterations)
+{
+    if (n == 1U) return 1U;
+
+    // Degenerate polynomial constants — skip.
+    if (c == 0U || c == n - 2U) return 1U;
+
+    BigInteger y = 2U;      // tortoise checkpoint
+    BigInteger r = 1U;      // Brent's power-of-2 cycle length
+    BigInteger q = 1U;      // accumulated product for batched GCD
+    BigInteger x, ys, factor;
+
+    const size_t batchSize = 128U;  // batch GCD every this many steps
+    size_t iterations = 0U;
+
+    // True if this walk should give up
+    const auto isOver = [&stop, &iterations, maxIterations]() {
+        return stop.load(std::memory_order_relaxed) || (maxIterations && (iterations > maxIterations));
+    };
+
+    do {
+        x = y;
+        // Advance tortoise to start of next Brent segment
+        for (BigInteger i = 0U; i < r; ++i, ++iterations) {
+            if (!(i % batchSize) && isOver()) return 1U;
+            y = (y * y + c) % n;
+        }
+
+        BigInteger k = 0U;
+        factor = 1U;
+
+        while (k < r && factor == 1U) {
+            if (isOver()) return 1U;
+            ys = y;
+            const BigInteger steps = std::min(batchSize, (size_t)(r - k));
+            for (BigInteger i = 0U; i < steps; ++i) {
+                y = (y * y + c) % n;
+                const BigInteger diff = (y > x) ? (y - x) : (x - y);
+                q = (q * diff) % n;
+            }
+            factor = gcd(n, q);
+            k += steps;
+            iterations += (size_t)steps;
+        }
+
+        r <<= 1U;
+
+    } while (factor == 1U);
+
+    // If we got n itself, fall back to step-by-step from last checkpoint
+    if (factor == n) {
+        factor = 1U;
+        y = ys;
+        while (factor == 1U) {
+            if (stop.load(std::memory_order_relaxed)) return 1U;
+            y = (y * y + c) % n;
+            const BigInteger diff = (y > x) ? (y - x) : (x - y);
+            factor = gcd(n, diff);
+        }
+    }
+
+    return (factor == n) ? 1U : factor;
+}
+
+// Driver: try multiple (c) values on the dispatch pool, one walk per thread at a time.
+// With a nonzero maxIterations, there is only one round of walks, each capped at that many steps.
+// Nodes take interleaved c values, so no two nodes (or threads) ever repeat a walk.
+// Returns a non-trivial factor, or 1 if all attempts failed.
+BigInteger pollardRho(const BigInteger& n, const BigInteger& sqrtN, size_t maxIterations = 0U, size_t nodeCount = 1U, size_t nodeId = 0U)
+{
+    if (n <= 3U) return 1U;
+
+    // Quick perfect-square check (already done in caller, but be safe)
+    if (sqrtN * sqrtN == n) return sqrtN;
+
+    std::atomic<bool> found(false);
+    std::atomic<size_t> nextAttempt(0U);
+    BigInteger result = 1U;
+    std::mutex resultMutex;
+
+    // Each walk tries a different c value.  c = 1 is the classic choice;
+    // we fan out from there, with c = 1 + nodeId + nodeCount * attempt on this node.
+    // Values 0 and n-2 are degenerate — skip them.
+    // Walks are claimed by CpuCount threads, so cores are never oversubscribed,
+    // and the first factor found stops every other walk at its next GCD batch.
+    const size_t maxAttempts = maxIterations ? CpuCount : (CpuCount * 8U);
+
+    for (unsigned cpu = 0U; cpu < CpuCount; ++cpu) {
+        dispatch.dispatch([&n, &found, &nextAttempt, &result, &resultMutex, maxAttempts, maxIterations, nodeCount, nodeId]() -> bool {
+            for (size_t attempt = nextAttempt++; (attempt < maxAttempts) && !found.load(std::memory_order_relaxed); attempt = nextAttempt++) {
+                const BigInteger c = (BigInteger)(1U + nodeId + nodeCount * attempt);
+                if (c == n - 2U) continue;
+
+                const BigInteger f = pollardRhoBrent(n, c, found, maxIterations);
+                if (f > 1U && f < n) {
+                    std::lock_guard<std::mutex> lk(resultMutex);
+                    if (result == 1U) result = f;
+                    found.store(true, std::memory_order_relaxed);
+                }
+            }
+            // (Returning true would stop the dispatch queue for good.)
+            return false;
+        });
+    }
+    dispatch.finish();
+
+    return result;
+}
+
+// Multi-lane Pollard's Rho, for batches of numbers of up to RhoLaneLimbs 64-bit limbs.
+// Each thread keeps RhoLaneCount independent walks ("lanes") in fixed-width Montgomery arithmetic, and steps them in turn,
+// so the multiply chains of different numbers overlap in the pipeline. A lane retires as soon as its number splits
+// (or its walk gives up), and takes the next number from the batch.
+constexpr size_t RhoLaneLimbs = 4U;
+constexpr size_t RhoLaneCount = 8U;
+
+#if defined(__SIZEOF_INT128__)
+typedef unsigned __int128 LaneWide;
+
+template <size_t L> struct RhoLane {
+  size_t index;
+  size_t step;
+  size_t checkpointStep;
+  size_t attempt;
+  uint64_t nPrime;
+  uint64_t n[L];
+  uint64_t c[L];
+  uint64_t x[L];
+  uint64_t ys[L];
+  uint64_t q[L];
+  uint64_t checkpointX[L];
+  uint64_t checkpointYs[L];
+};
+
+template <size_t L> inline bool laneLess(const uint64_t *a, const uint64_t *b) {
+  for (size_t j = L; j-- > 0U;) {
+    if (a[j] != b[j]) {
+      return a[j] < b[j];
+    }
+  }
+
+  return false;
+}
+
+// r = a - b, returning the borrow
+template <size_t L> inline uint64_t laneSub(uint64_t *r, const uint64_t *a, const uint64_t *b) {
+  uint64_t borrow = 0U;
+  for (size_t j = 0U; j < L; ++j) {
+    const LaneWide d = (LaneWide)a[j] - b[j] - borrow;
+    r[j] = (uint64_t)d;
+    borrow = (uint64_t)(d >> 64U) & 1U;
+  }
+
+  return borrow;
+}
+
+// x = (x + c) mod n
+template <size_t L> inline void laneAddMod(uint64_t *x, const uint64_t *c, const uint64_t *n) {
+  uint64_t carry = 0U;
+  for (size_t j = 0U; j < L; ++j) {
+    const LaneWide s = (LaneWide)x[j] + c[j] + carry;
+    x[j] = (uint64_t)s;
+    carry = (uint64_t)(s >> 64U);
+  }
+  if (carry || !laneLess<L>(x, n)) {
+    laneSub<L>(x, x, n);
+  }
+}
+
+// r = a b / 2^(64 L) mod n, by coarsely integrated operand scanning (CIOS), for a, b < n
+template <size_t L> inline void laneMontMul(uint64_t *r, const uint64_t *a, const uint64_t *b, const uint64_t *n, uint64_t nPrime) {
+  uint64_t t[L + 2U] = {};
+  for (size_t i = 0U; i < L; ++i) {
+    uint64_t carry = 0U;
+    for (size_t j = 0U; j < L; ++j) {
+      const LaneWide s = (LaneWide)a[j] * b[i] + t[j] + carry;
+      t[j] = (uint64_t)s;
+      carry = (uint64_t)(s >> 64U);
+    }
+    LaneWide s = (LaneWide)t[L] + carry;
+    t[L] = (uint64_t)s;
+    t[L + 1U] = (uint64_t)(s >> 64U);
+
+    const uint64_t m = t[0U] * nPrime;
+    s = (LaneWide)m * n[0U] + t[0U];
+    carry = (uint64_t)(s >> 64U);
+    for (size_t j = 1U; j < L; ++j) {
+      s = (LaneWide)m * n[j] + t[j] + carry;
+      t[j - 1U] = (uint64_t)s;
+      carry = (uint64_t)(s >> 64U);
+    }
+    s = (LaneWide)t[L] + carry;
+    t[L - 1U] = (uint64_t)s;
+    t[L] = t[L + 1U] + (uint64_t)(s >> 64U);
+  }
+  if (t[L] || !laneLess<L>(t, n)) {
+    laneSub<L>(t, t, n);
+  }
+  std::copy(t, t + L, r);
+}
+
+template <size_t L> inline BigInteger laneValue(const uint64_t *a) {
+  BigInteger v = 0U;
+  for (size_t j = L; j-- > 0U;) {
+    v = (v << 64U) | a[j];
+  }
+
+  return v;
+}
+
+// One step of Brent's walk x <- x^2 + c (on Montgomery representatives, so c is just another constant).
+// At power-of-two steps, the walk saves x as the value to compare against; otherwise, it accumulates |x - ys| into q.
+// Returns false at a save step, when there's no new difference.
+template <size_t L> inline bool laneStep(RhoLane<L> &lane, uint64_t *diff) {
+  laneMontMul<L>(lane.x, lane.x, lane.x, lane.n, lane.nPrime);
+  laneAddMod<L>(lane.x, lane.c, lane.n);
+  ++lane.step;
+  if (!(lane.step & (lane.step - 1U))) {
+    std::copy(lane.x, lane.x + L, lane.ys);
+    return false;
+  }
+  if (laneSub<L>(diff, lane.x, lane.ys)) {
+    laneSub<L>(diff, lane.ys, lane.x);
+  }
+
+  return true;
+}
+
+// Start (or restart) a lane's walk, with constant c = attempt + 1, from x = 2
+template <size_t L> void laneStart(RhoLane<L> &lane) {
+  std::fill(lane.c, lane.c + L, 0U);
+  std::fill(lane.x, lane.x + L, 0U);
+  std::fill(lane.q, lane.q + L, 0U);
+  lane.c[0U] = lane.attempt + 1U;
+  lane.x[0U] = 2U;
+  lane.q[0U] = 1U;
+  std::copy(lane.x, lane.x + L, lane.ys);
+  std::copy(lane.x, lane.x + L, lane.checkpointX);
+  std::copy(lane.x, lane.x + L, lane.checkpointYs);
+  lane.step = 0U;
+  lane.checkpointStep = 0U;
+}
+
+// Run the numbers at "indices" on RhoLaneCount lanes of L limbs, taking them in turn from "next"
+template <size_t L> void pollardRhoLanes(const std::vector<BigInteger> &numbers, const std::vector<size_t> &indices, std::atomic<size_t> &next,
+                                         std::vector<BigInteger> &results, size_t maxIterations) {
+  constexpr size_t gcdInterval = 256U;
+  constexpr size_t maxAttempts = 16U;
+  const size_t none = (size_t)-1;
+  RhoLane<L> lanes[RhoLaneCount];
+  uint64_t diff[L];
+  const auto fill = [&](RhoLane<L> &lane) {
+    lane.index = none;
+    const size_t i = next++;
+    if (i >= indices.size()) {
+      return;
+    }
+    lane.index = indices[i];
+    const BigInteger &n = numbers[lane.index];
+    for (size_t j = 0U; j < L; ++j) {
+      lane.n[j] = (uint64_t)(n >> (64U * j));
+    }
+    // -1 / n mod 2^64, by Newton's method (each step doubles the correct low bits)
+    uint64_t inv = lane.n[0U];
+    for (size_t k = 0U; k < 5U; ++k) {
+      inv *= 2U - lane.n[0U] * inv;
+    }
+    lane.nPrime = 0U - inv;
+    lane.attempt = 0U;
+    laneStart<L>(lane);
+  };
+  const auto retire = [&](RhoLane<L> &lane, const BigInteger &factor) {
+    results[lane.index] = factor;
+    fill(lane);
+  };
+
+  size_t active = 0U;
+  for (RhoLane<L> &lane : lanes) {
+    fill(lane);
+    active += (lane.index != none);
+  }
+  while (active) {
+    for (size_t s = 0U; s < gcdInterval; ++s) {
+      for (RhoLane<L> &lane : lanes) {
+        if ((lane.index != none) && laneStep<L>(lane, diff)) {
+          laneMontMul<L>(lane.q, lane.q, diff, lane.n, lane.nPrime);
+        }
+      }
+    }
+
+    active = 0U;
+    for (RhoLane<L> &lane : lanes) {
+      if (lane.index == none) {
+        continue;
+      }
+      const BigInteger n = laneValue<L>(lane.n);
+      BigInteger g = gcd(laneValue<L>(lane.q), n);
+      if (g == 1U) {
+        if (maxIterations && (lane.step > maxIterations)) {
+          retire(lane, 1U);
+        } else {
+          std::copy(lane.x, lane.x + L, lane.checkpointX);
+          std::copy(lane.ys, lane.ys + L, lane.checkpointYs);
+          lane.checkpointStep = lane.step;
+        }
+      } else {
+        if (g == n) {
+          // Every factor turned up in the same batch, so step through it again, one GCD at a time.
+          std::copy(lane.checkpointX, lane.checkpointX + L, lane.x);
+          std::copy(lane.checkpointYs, lane.checkpointYs + L, lane.ys);
+          lane.step = lane.checkpointStep;
+          g = 1U;
+          for (size_t s = 0U; (s < gcdInterval) && (g == 1U); ++s) {
+            if (laneStep<L>(lane, diff)) {
+              g = gcd(laneValue<L>(diff), n);
+            }
+          }
+        }
+        if ((g != 1U) && (g != n)) {
+          retire(lane, g);
+        } else if (++lane.attempt < maxAttempts) {
+          // (The walk cycled modulo n itself, so try another constant.)
+          laneStart<L>(lane);
+        } else {
+          retire(lane, 1U);
+        }
+      }
+      active += (lane.index != none);
+    }
+  }
+}
+#endif
+
+// Split every number in a batch with Pollard's Rho, on every thread at once.
+// Numbers of up to RhoLaneLimbs limbs go to the multi-lane kernel, and larger ones (or all of them, without 128-bit
+// integers) go one at a time to pollardRho(). Each result is a nontrivial factor, or 1 for a prime (by a Miller-Rabin test),
+// for numbers below 4, or if every walk gives up (after maxIterations steps, if that's nonzero).
+std::vector<BigInteger> pollardRhoBatch(const std::vector<BigInteger> &numbers, size_t maxIterations) {
+  std::vector<BigInteger> results(numbers.size(), 1U);
+  // Odd composites, by limb count (with the last group for any that don't fit a lane)
+  std::vector<std::vector<size_t>> groups(RhoLaneLimbs + 1U);
+  for (size_t i = 0U; i < numbers.size(); ++i) {
+    const BigInteger &n = numbers[i];
+    if (n < 4U) {
+      continue;
+    }
+    if (!(n & 1U)) {
+      results[i] = 2U;
+      continue;
+    }
+    if (boost::multiprecision::miller_rabin_test(n, 25U)) {
+      continue;
+    }
+    const size_t limbs = (msb(n) >> 6U) + 1U;
+#if defined(__SIZEOF_INT128__)
+    groups[std::min(limbs, RhoLaneLimbs + 1U) - 1U].push_back(i);
+#else
+    groups[RhoLaneLimbs].push_back(i);
+#endif
+  }
+
+#if defined(__SIZEOF_INT128__)
+  for (size_t g = 0U; g < RhoLaneLimbs; ++g) {
+    const std::vector<size_t> &indices = groups[g];
+    if (indices.empty()) {
+      continue;
+    }
+    std::atomic<size_t> next(0U);
+    const size_t threadCount = std::min((size_t)CpuCount, (indices.size() + RhoLaneCount - 1U) / RhoLaneCount);
+    for (size_t cpu = 0U; cpu < threadCount; ++cpu) {
+      dispatch.dispatch([&numbers, &indices, &next, &results, g, maxIterations]() -> bool {
+        switch (g + 1U) {
+        case 1U:
+          pollardRhoLanes<1U>(numbers, indices, next, results, maxIterations);
+          break;
+        case 2U:
+          pollardRhoLanes<2U>(numbers, indices, next, results, maxIterations);
+          break;
+        case 3U:
+          pollardRhoLanes<3U>(numbers, indices, next, results, maxIterations);
+          break;
+        default:
+          pollardRhoLanes<4U>(numbers, indices, next, results, maxIterations);
+          break;
+        }
+        // (Returning true would stop the dispatch queue for good.)
+        return false;
+      });
+    }
+    dispatch.finish();
+  }
+#endif
+  for (const size_t &i : groups[RhoLaneLimbs]) {
+    results[i] = pollardRho(numbers[i], sqrt(numbers[i]), maxIterations);
+  }
+
+  return results;
+}
+
+// Steps of Fermat's method that find_a_factor() always tries first, for factors close to the square root
+constexpr size_t FermatBudget = 1U << 16U;
+
+// Which residues modulo "m" are squares
+std::vector<bool> quadraticResidues(size_t m) {
+  std::vector<bool> isResidue(m);
+  for (size_t i = 0U; i < m; ++i) {
+    isResidue[(i * i) % m] = true;
+  }
+
+  return isResidue;
+}
+
+// Fermat's method: n = a^2 - b^2 = (a - b)(a + b), for a from sqrtN + 1, for at most "steps" values of a.
+// This finds factors p and q within about 2 sqrt(2 steps) n^(1/4) of each other, in a handful of steps if they're much closer.
+// a^2 - n is only tested for a square (by BigInteger sqrt()) if it passes quadratic residue filters modulo 64, 63, 65, and 11,
+// which are tracked incrementally in native integers. Returns a nontrivial factor, or 1.
+BigInteger fermat(const BigInteger &n, const BigInteger &sqrtN, size_t steps) {
+  static const size_t moduli[4U] = {64U, 63U, 65U, 11U};
+  static const std::vector<bool> isResidue[4U] = {quadraticResidues(64U), quadraticResidues(63U), quadraticResidues(65U), quadraticResidues(11U)};
+
+  BigInteger a = sqrtN + 1U;
+  BigInteger r = a * a - n;
+  size_t aMod[4U], rMod[4U];
+  for (size_t i = 0U; i < 4U; ++i) {
+    aMod[i] = (size_t)(a % moduli[i]);
+    rMod[i] = (size_t)(r % moduli[i]);
+  }
+
+  for (size_t step = 0U; step < steps; ++step) {
+    bool isCandidate = true;
+    for (size_t i = 0U; (i < 4U) && isCandidate; ++i) {
+      isCandidate = isResidue[i][rMod[i]];
+    }
+    if (isCandidate) {
+      const BigInteger b = sqrt(r);
+      if ((b * b) == r) {
+        const BigInteger f = a - b;
+        return (f == n) ? (BigInteger)1U : f;
+      }
+    }
+    // (a + 1)^2 - n = r + 2a + 1
+    r += (a << 1U) + 1U;
+    ++a;
+    for (size_t i = 0U; i < 4U; ++i) {
+      rMod[i] = (rMod[i] + (aMod[i] << 1U) + 1U) % moduli[i];
+      aMod[i] = (aMod[i] + 1U) % moduli[i];
+    }
+  }
+
+  return 1U;
+}
+
+// Steps per rho walk to expect a factor of up to "factorBits" bits, if n has one.
+// (A walk needs about sqrt(pi * p / 2) steps to find p; this allows a few times that.)
+size_t pollardRhoBudget(const BigInteger& n, size_t factorBits)
+{
+    // The smallest nontrivial factor has at most half the bits of n.
+    factorBits = std::min(std::min(factorBits, (size_t)((msb(n) + 2U) >> 1U)), (size_t)120U);
+
+    return (size_t)(4.0 * pow(2.0, factorBits / 2.0)) + 1U;
+}
+
+// Inverse of "a" modulo "n", by the extended Euclidean algorithm, or 0 if gcd(a, n) is not 1.
+BigInteger modInverse(const BigInteger& a, const BigInteger& n) {
+  BigInteger r0 = n, r1 = a % n;
+  BigInteger t0 = 0U, t1 = 1U;
+  while (r1) {
+    const BigInteger q = r0 / r1;
+    BigInteger t = r0 - q * r1;
+    r0 = r1;
+    r1 = t;
+    t = t0 - q * t1;
+    t0 = t1;
+    t1 = t;
+  }
+  if (r0 != 1U) {
+    return 0U;
+  }
+
+  return (t0 < 0) ? (BigInteger)(t0 + n) : t0;
+}
+
+// Inverse of "a" modulo a word-sized "p" (below 2^63), or 0 if gcd(a, p) is not 1.
+size_t modInverse(size_t a, size_t p) {
+  int64_t r0 = (int64_t)p, r1 = (int64_t)(a % p);
+  int64_t t0 = 0, t1 = 1;
+  while (r1) {
+    const int64_t q = r0 / r1;
+    int64_t t = r0 - q * r1;
+    r0 = r1;
+    r1 = t;
+    t = t0 - q * t1;
+    t0 = t1;
+    t1 = t;
+  }
+  if (r0 != 1) {
+    return 0U;
+  }
+
+  return (size_t)((t0 < 0) ? (t0 + (int64_t)p) : t0);
+}
+
+inline size_t mulMod(size_t a, size_t b, size_t p) {
+#if defined(__SIZEOF_INT128__)
+  return (size_t)(((unsigned __int128)a * b) % p);
+#else
+  if (p <= 0xFFFFFFFFULL) {
+    return (a * b) % p;
+  }
+  return (size_t)(((BigInteger)a * b) % p);
+#endif
+}
+
+inline BigInteger mulMod(const BigInteger &a, const BigInteger &b, const BigInteger &n) { return (a * b) % n; }
+
+// Montgomery's trick, for one chunk of values (all reduced modulo n): one modular inversion and 3(count - 1) multiplications.
+// Returns 1 if every value was replaced by its inverse, or else the first nontrivial gcd(value, n), leaving this chunk as it was.
+template <typename T> T batchModInverseChunk(T *values, size_t count, const T &n) {
+  if (!count) {
+    return 1U;
+  }
+  // prefix[i] is the product of values[0] through values[i].
+  std::vector<T> prefix(count);
+  prefix[0U] = values[0U];
+  for (size_t i = 1U; i < count; ++i) {
+    prefix[i] = mulMod(prefix[i - 1U], values[i], n);
+  }
+  T inv = modInverse(prefix[count - 1U], n);
+  if (!inv) {
+    // Some value shares a factor with n. (Every prime that divides the product divides one of the values.)
+    for (size_t i = 0U; i < count; ++i) {
+      const T g = (T)gcd((BigInteger)values[i], (BigInteger)n);
+      if (g != 1U) {
+        return g;
+      }
+    }
+    return n;
+  }
+  // Peel off one value at a time: inv is the inverse of prefix[i], so inv * prefix[i - 1] is the inverse of values[i].
+  for (size_t i = count - 1U; i > 0U; --i) {
+    const T v = values[i];
+    values[i] = mulMod(inv, prefix[i - 1U], n);
+    inv = mulMod(inv, v, n);
+  }
+  values[0U] = inv;
+
+  return 1U;
+}
+
+// Replaces every value (reduced modulo n) with its inverse modulo n, by Montgomery's trick.
+// If isParallel, values are split into CpuCount chunks, each inverted on the dispatch pool (so don't set it from a dispatched task).
+// Returns 1 on success. If a value shares a factor with n, that gcd is returned instead, which is a factor of n
+// (or n itself, if a value is 0 modulo n), and only some (or none) of the values have been inverted.
+template <typename T> T batchModInverse(std::vector<T> &values, const T &n, bool isParallel = false) {
+  const size_t chunkCount = isParallel ? std::min((size_t)CpuCount, values.size()) : 1U;
+  if (chunkCount < 2U) {
+    return batchModInverseChunk(values.data(), values.size(), n);
+  }
+
+  const size_t chunkSize = (values.size() + chunkCount - 1U) / chunkCount;
+  std::vector<T> results(chunkCount, 1U);
+  for (size_t c = 0U; c < chunkCount; ++c) {
+    dispatch.dispatch([&values, &results, &n, c, chunkSize]() -> bool {
+      const size_t start = c * chunkSize;
+      if (start < values.size()) {
+        results[c] = batchModInverseChunk(values.data() + start, std::min(chunkSize, values.size() - start), n);
+      }
+      return false;
+    });
+  }
+  dispatch.finish();
+
+  for (const T &r : results) {
+    if (r != 1U) {
+      return r;
+    }
+  }
+
+  return 1U;
+}
+
+// Montgomery multiplication modulo an odd "n", with R = 2^bits for a whole number of 64-bit words.
+// Values in Montgomery form are aR mod n. Reduction only takes masks and shifts, where "%" would take long division.
+struct Montgomery {
+  BigInteger n;
+  // -1/n mod R
+  BigInteger nPrime;
+  BigInteger mask;
+  size_t bits;
+  // 1 in Montgomery form (R mod n)
+  BigInteger one;
+
+  Montgomery(const BigInteger &modulus) : n(modulus) {
+    bits = ((msb(n) >> 6U) + 1U) << 6U;
+    mask = (((BigInteger)1U) << bits) - 1U;
+    // Newton's iteration for 1/n mod R doubles the correct low bits each step, starting from 1 bit for odd n.
+    BigInteger inv = 1U;
+    for (size_t b = 1U; b < bits; b <<= 1U) {
+      inv = (inv * ((mask + 3U) - ((n * inv) & mask))) & mask;
+    }
+    nPrime = (mask + 1U) - inv;
+    one = to(1U);
+  }
+
+  BigInteger to(const BigInteger &a) const { return (a << bits) % n; }
+  BigInteger from(const BigInteger &a) const { return mul(a, 1U); }
+
+  BigInteger mul(const BigInteger &a, const BigInteger &b) const {
+    const BigInteger t = a * b;
+    BigInteger r = (t + (((t & mask) * nPrime) & mask) * n) >> bits;
+    if (r >= n) {
+      r -= n;
+    }
+
+    return r;
+  }
+
+  BigInteger add(const BigInteger &a, const BigInteger &b) const {
+    const BigInteger r = a + b;
+    return (r >= n) ? (BigInteger)(r - n) : r;
+  }
+
+  BigInteger sub(const BigInteger &a, const BigInteger &b) const { return (a >= b) ? (BigInteger)(a - b) : (BigInteger)((a + n) - b); }
+
+  BigInteger pow(const BigInteger &a, BigInteger e) const {
+    BigInteger r = one;
+    for (size_t i = e ? (msb(e) + 1U) : 0U; i > 0U; --i) {
+      r = mul(r, r);
+      if (bit_test(e, i - 1U)) {
+        r = mul(r, a);
+      }
+    }
+
+    return r;
+  }
+
+  // Lucas sequence V_m(v), for v = x + 1/x, so V_m = x^m + 1/x^m (all in Montgomery form).
+  BigInteger lucasV(const BigInteger &v, const BigInteger &m) const {
+    if (!m) {
+      return add(one, one);
+    }
+    const BigInteger two = add(one, one);
+    // Ladder on (V_k, V_(k+1)), from k = 1, with V_(2k) = V_k^2 - 2 and V_(2k+1) = V_k V_(k+1) - V_1
+    BigInteger lo = v;
+    BigInteger hi = sub(mul(v, v), two);
+    for (size_t i = msb(m); i > 0U; --i) {
+      if (bit_test(m, i - 1U)) {
+        lo = sub(mul(lo, hi), v);
+        hi = sub(mul(hi, hi), two);
+      } else {
+        hi = sub(mul(lo, hi), v);
+        lo = sub(mul(lo, lo), two);
+      }
+    }
+
+    return lo;
+  }
+};
+
+// Stage 2 of Pollard's p - 1 and Williams' p + 1: baby-step giant-step over the primes q in primes[b1Count:],
+// with q = kD +/- j for 0 < j < D/2. Given v1 = V_1 = x + 1/x, after stage 1 (in Montgomery form),
+// p divides V_kD - V_j if x^q = 1 (mod p) for either sign, so each pair of primes kD - j and kD + j costs one multiplication.
+// Returns 1 if it finds no nontrivial factor, or if "stop" is set.
+BigInteger lucasStage2(const Montgomery &mont, const std::vector<size_t> &primes, size_t b1Count, const BigInteger &v1, const std::atomic<bool> *stop = nullptr) {
+  const BigInteger &n = mont.n;
+  if (b1Count >= primes.size()) {
+    return 1U;
+  }
+  const BigInteger two = mont.add(mont.one, mont.one);
+  const size_t d = (primes.back() > 1000000U) ? 2310U : 210U;
+  const size_t halfD = d >> 1U;
+
+  // Baby steps: V_j for odd j up to D / 2, from V_(j+2) = V_j V_2 - V_(j-2)
+  std::vector<BigInteger> babySteps(halfD + 1U);
+  const BigInteger v2 = mont.sub(mont.mul(v1, v1), two);
+  babySteps[1U] = v1;
+  babySteps[3U] = mont.sub(mont.mul(v1, v2), v1);
+  for (size_t j = 5U; j <= halfD; j += 2U) {
+    babySteps[j] = mont.sub(mont.mul(babySteps[j - 2U], v2), babySteps[j - 4U]);
+  }
+
+  // Giant steps: V_kD, from V_(k+1)D = V_kD V_D - V_(k-1)D
+  constexpr size_t gcdInterval = 256U;
+  const BigInteger vD = mont.sub(mont.mul(babySteps[halfD], babySteps[halfD]), two);
+  auto it = primes.begin() + b1Count;
+  size_t k = (*it + halfD) / d;
+  BigInteger vPrev = mont.lucasV(vD, k ? (k - 1U) : 1U);
+  BigInteger vCur = mont.lucasV(vD, k);
+  BigInteger product = mont.one;
+  std::vector<bool> isPaired(halfD + 1U);
+  size_t batchCount = 0U;
+  while (it != primes.end()) {
+    std::fill(isPaired.begin(), isPaired.end(), false);
+    const size_t windowEnd = k * d + halfD;
+    for (; (it != primes.end()) && (*it <= windowEnd); ++it) {
+      const size_t j = (*it > (k * d)) ? (*it - k * d) : (k * d - *it);
+      // (Only primes that divide D itself have even j, or j that shares a factor with D.)
+      if (!(j & 1U) || isPaired[j]) {
+        continue;
+      }
+      isPaired[j] = true;
+      product = mont.mul(product, mont.sub(vCur, babySteps[j]));
+    }
+
+    if (!(++batchCount % gcdInterval) || (it == primes.end())) {
+      if (stop && stop->load(std::memory_order_relaxed)) {
+        return 1U;
+      }
+      const BigInteger g = gcd(n, mont.from(product));
+      if (g != 1U) {
+        return (g == n) ? 1U : g;
+      }
+    }
+
+    const BigInteger vNext = mont.sub(mont.mul(vCur, vD), vPrev);
+    vPrev = vCur;
+    vCur = vNext;
+    ++k;
+  }
+
+  return 1U;
+}
+
+// Pollard's p - 1: finds a prime factor p of n if p - 1 is a product of prime powers up to b1,
+// times at most one more prime up to b2. Returns 1 if it finds no nontrivial factor.
+// Each node starts from its own base, 3 + nodeId, so the order of the base modulo p differs between nodes.
+BigInteger pollardPm1(const BigInteger &n, size_t b1, size_t b2, size_t nodeId = 0U) {
+  if (!(n & 1U)) {
+    return 2U;
+  }
+  if (!(n % 3U)) {
+    return 3U;
+  }
+  if (b2 < b1) {
+    b2 = b1;
+  }
+
+  const Montgomery mont(n);
+  const std::vector<size_t> primes = SieveOfEratosthenes(b2);
+  const size_t b1Count = std::distance(primes.begin(), std::upper_bound(primes.begin(), primes.end(), b1));
+  // Largest power of each prime up to b1
+  const auto primePower = [&primes, b1](size_t i) {
+    const size_t p = primes[i];
+    size_t q = p;
+    while (q <= (b1 / p)) {
+      q *= p;
+    }
+    return q;
+  };
+
+  // Stage 1: a = base^E, for E the product of every prime power up to b1.
+  // We take a GCD every batch of primes, and if a batch finds every factor at once, we retry it one prime at a time.
+  constexpr size_t gcdInterval = 256U;
+  BigInteger a = mont.to((BigInteger)(3U + nodeId) % n);
+  BigInteger checkpoint = a;
+  size_t checkpointIndex = 0U;
+  for (size_t i = 0U; i < b1Count; ++i) {
+    a = mont.pow(a, primePower(i));
+    if ((((i + 1U) % gcdInterval) != 0U) && ((i + 1U) != b1Count)) {
+      continue;
+    }
+    BigInteger g = gcd(n, mont.from(a) - 1U);
+    if (g == 1U) {
+      checkpoint = a;
+      checkpointIndex = i + 1U;
+      continue;
+    }
+    if (g != n) {
+      return g;
+    }
+    a = checkpoint;
+    for (size_t j = checkpointIndex; j <= i; ++j) {
+      a = mont.pow(a, primePower(j));
+      g = gcd(n, mont.from(a) - 1U);
+      if (g != 1U) {
+        return (g == n) ? 1U : g;
+      }
+    }
+
+    return 1U;
+  }
+  if (b1Count == primes.size()) {
+    return 1U;
+  }
+
+  // Stage 2, in terms of V_m = b^m + b^(-m)
+  const BigInteger b = mont.from(a);
+  const BigInteger bInv = modInverse(b, n);
+  if (!bInv) {
+    const BigInteger g = gcd(n, b);
+    return (g == n) ? 1U : g;
+  }
+
+  return lucasStage2(mont, primes, b1Count, mont.to((b + bInv) % n));
+}
+
+// Williams' p + 1: finds a prime factor p of n if p + 1 (or p - 1) is a product of prime powers up to b1,
+// times at most one more prime up to b2, for the Lucas sequence of a seed.
+// Each seed P0 works for p + 1 only if P0^2 - 4 is a non-residue mod p (about half of seeds), so the dispatch pool runs
+// max(CpuCount, 3) seeds at once, and the first factor found stops the rest. Returns 1 if it finds no nontrivial factor.
+// Nodes take interleaved seeds, so no two nodes run the same one.
+BigInteger williamsPp1(const BigInteger &n, size_t b1, size_t b2, size_t nodeCount = 1U, size_t nodeId = 0U) {
+  if (!(n & 1U)) {
+    return 2U;
+  }
+  if (b2 < b1) {
+    b2 = b1;
+  }
+
+  const Montgomery mont(n);
+  const BigInteger two = mont.add(mont.one, mont.one);
+  const std::vector<size_t> primes = SieveOfEratosthenes(b2);
+  const size_t b1Count = std::distance(primes.begin(), std::upper_bound(primes.begin(), primes.end(), b1));
+  const size_t seedCount = std::max(CpuCount, 3U);
+
+  std::atomic<bool> found(false);
+  std::atomic<size_t> nextSeed(0U);
+  BigInteger result = 1U;
+  std::mutex resultMutex;
+  const auto report = [&n, &found, &result, &resultMutex](const BigInteger &g) {
+    if ((g == 1U) || (g == n)) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(resultMutex);
+    if (result == 1U) {
+      result = g;
+    }
+    found.store(true, std::memory_order_relaxed);
+
+    return true;
+  };
+
+  for (unsigned cpu = 0U; cpu < std::min(CpuCount, (unsigned)seedCount); ++cpu) {
+    dispatch.dispatch([&]() -> bool {
+      for (size_t seed = nextSeed++; (seed < seedCount) && !found.load(std::memory_order_relaxed); seed = nextSeed++) {
+        // Stage 1: V = V_E(P0), for E the product of every prime power up to b1, as nested Lucas chains (V_mn = V_m(V_n)).
+        // (Seeds are 3, 4, 5, ..., for a spread of P0^2 - 4 across square classes, with 3 + nodeId + nodeCount * seed on this node.)
+        BigInteger v = mont.to((BigInteger)(3U + nodeId + nodeCount * seed) % n);
+        bool isSpent = false;
+        for (size_t i = 0U; (i < b1Count) && !found.load(std::memory_order_relaxed); ++i) {
+          const size_t p = primes[i];
+          size_t q = p;
+          while (q <= (b1 / p)) {
+            q *= p;
+          }
+          v = mont.lucasV(v, q);
+          if (!((i + 1U) % 256U) || ((i + 1U) == b1Count)) {
+            const BigInteger g = gcd(n, mont.from(mont.sub(v, two)));
+            if (g != 1U) {
+              // (If every factor turned up at once, this seed is spent.)
+              report(g);
+              isSpent = true;
+              break;
+            }
+          }
+        }
+        if (isSpent || found.load(std::memory_order_relaxed)) {
+          continue;
+        }
+        report(lucasStage2(mont, primes, b1Count, v, &found));
+      }
+      // (Returning true would stop the dispatch queue for good.)
+      return false;
+    });
+  }
+  dispatch.finish();
+
+  return result;
+}
+
+// A point on a Montgomery curve By^2 = x^3 + Ax^2 + x, in projective x-only coordinates (X : Z), in Montgomery form.
+struct MontgomeryPoint {
+  BigInteger x;
+  BigInteger z;
+};
+
+// Lenstra's elliptic curve method, on Montgomery curves, with arithmetic modulo n in Montgomery form.
+class EllipticCurve {
+public:
+  // Suyama's parameterization, from sigma >= 6, gives a curve with a rational 12-torsion subgroup, and a starting point.
+  // If (A + 2) / 4 is not invertible, a factor of n falls out of the parameterization; "factor" holds it, or else 1.
+  EllipticCurve(const Montgomery &m, size_t sigma, BigInteger &factor) : mont(m) {
+    const BigInteger &n = mont.n;
+    const BigInteger s = sigma;
+    const BigInteger u = (s * s + n - 5U) % n;
+    const BigInteger v = (4U * s) % n;
+    const BigInteger u3 = (u * u * u) % n;
+    const BigInteger v3 = (v * v * v) % n;
+    // (A + 2) / 4 = (v - u)^3 (3u + v) / (16 u^3 v)
+    const BigInteger vmu = (v + n - u) % n;
+    const BigInteger num = (vmu * vmu * vmu * ((3U * u + v) % n)) % n;
+    const BigInteger den = (16U * u3 * v) % n;
+    const BigInteger denInv = modInverse(den, n);
+    factor = 1U;
+    if (!denInv) {
+      factor = gcd(n, den);
+      return;
+    }
+    a24 = mont.to((num * denInv) % n);
+    start = {mont.to(u3), mont.to(v3)};
+  }
+
+  MontgomeryPoint start;
+
+  MontgomeryPoint dbl(const MontgomeryPoint &p) const {
+    const BigInteger s = mont.add(p.x, p.z);
+    const BigInteger d = mont.sub(p.x, p.z);
+    const BigInteger ss = mont.mul(s, s);
+    const BigInteger dd = mont.mul(d, d);
+    const BigInteger t = mont.sub(ss, dd);
+
+    return {mont.mul(ss, dd), mont.mul(t, mont.add(dd, mont.mul(a24, t)))};
+  }
+
+  // p + q, from p - q ("diff")
+  MontgomeryPoint add(const MontgomeryPoint &p, const MontgomeryPoint &q, const MontgomeryPoint &diff) const {
+    const BigInteger u = mont.mul(mont.sub(p.x, p.z), mont.add(q.x, q.z));
+    const BigInteger v = mont.mul(mont.add(p.x, p.z), mont.sub(q.x, q.z));
+    const BigInteger sum = mont.add(u, v);
+    const BigInteger dif = mont.sub(u, v);
+
+    return {mont.mul(diff.z, mont.mul(sum, sum)), mont.mul(diff.x, mont.mul(dif, dif))};
+  }
+
+  // kP, by the Montgomery ladder
+  MontgomeryPoint mul(const MontgomeryPoint &p, size_t k) const {
+    if (k < 2U) {
+      return p;
+    }
+    MontgomeryPoint r0 = p;
+    MontgomeryPoint r1 = dbl(p);
+    size_t top = 0U;
+    while (k >> (top + 1U)) {
+      ++top;
+    }
+    for (size_t i = top; i > 0U; --i) {
+      if ((k >> (i - 1U)) & 1U) {
+        r0 = add(r1, r0, p);
+        r1 = dbl(r1);
+      } else {
+        r1 = add(r0, r1, p);
+        r0 = dbl(r0);
+      }
+    }
+
+    return r0;
+  }
+
+  // Stage 1 multiplies the starting point by every prime power up to b1, and stage 2 looks for one more prime up to b2,
+  // by baby-step giant-step, as in lucasStage2(). Returns a nontrivial factor, or 1.
+  BigInteger factor(const std::vector<size_t> &primes, size_t b1Count, size_t b1, const std::atomic<bool> &stop) const {
+    const BigInteger &n = mont.n;
+    MontgomeryPoint q = start;
+    for (size_t i = 0U; i < b1Count; ++i) {
+      const size_t p = primes[i];
+      for (size_t pp = p; pp <= b1; pp *= p) {
+        q = mul(q, p);
+        if (pp > (b1 / p)) {
+          break;
+        }
+      }
+      if (!((i + 1U) % 256U) && stop.load(std::memory_order_relaxed)) {
+        return 1U;
+      }
+    }
+    BigInteger g = gcd(n, mont.from(q.z));
+    if ((g != 1U) || (b1Count >= primes.size())) {
+      return (g == n) ? 1U : g;
+    }
+
+    // Stage 2: p divides X_kD - x_j Z_kD if (kD +/- j) Q is the point at infinity mod p, for either sign.
+    const size_t d = (primes.back() > 1000000U) ? 2310U : 210U;
+    const size_t halfD = d >> 1U;
+    std::vector<MontgomeryPoint> babySteps(halfD + 1U);
+    const MontgomeryPoint q2 = dbl(q);
+    babySteps[1U] = q;
+    babySteps[3U] = add(q2, q, q);
+    for (size_t j = 5U; j <= halfD; j += 2U) {
+      babySteps[j] = add(babySteps[j - 2U], q2, babySteps[j - 4U]);
+    }
+    const MontgomeryPoint qD = dbl(babySteps[halfD]);
+    // Normalize the baby steps to Z = 1 with one batch inversion, so each prime pair costs one multiplication fewer.
+    // (If some Z is not invertible, its gcd with n is a factor, already.)
+    std::vector<BigInteger> zInverses;
+    for (size_t j = 1U; j <= halfD; j += 2U) {
+      zInverses.push_back(mont.from(babySteps[j].z));
+    }
+    g = batchModInverse(zInverses, n);
+    if (g != 1U) {
+      return (g == n) ? 1U : g;
+    }
+    for (size_t j = 1U; j <= halfD; j += 2U) {
+      babySteps[j].x = mont.mul(babySteps[j].x, mont.to(zInverses[j >> 1U]));
+    }
+    auto it = primes.begin() + b1Count;
+    // (The giant-step recurrence needs k - 1 > 0.)
+    size_t k = std::max((size_t)((*it + halfD) / d), (size_t)2U);
+    MontgomeryPoint prev = mul(qD, k - 1U);
+    MontgomeryPoint cur = mul(qD, k);
+    BigInteger product = mont.one;
+    std::vector<bool> isPaired(halfD + 1U);
+    size_t batchCount = 0U;
+    while (it != primes.end()) {
+      std::fill(isPaired.begin(), isPaired.end(), false);
+      const size_t windowEnd = k * d + halfD;
+      for (; (it != primes.end()) && (*it <= windowEnd); ++it) {
+        const size_t j = (*it > (k * d)) ? (*it - k * d) : (k * d - *it);
+        if ((j > halfD) || !(j & 1U) || isPaired[j]) {
+          continue;
+        }
+        isPaired[j] = true;
+        product = mont.mul(product, mont.sub(cur.x, mont.mul(babySteps[j].x, cur.z)));
+      }
+
+      if (!(++batchCount % 256U) || (it == primes.end())) {
+        if (stop.load(std::memory_order_relaxed)) {
+          return 1U;
+        }
+        g = gcd(n, mont.from(product));
+        if (g != 1U) {
+          return (g == n) ? 1U : g;
+        }
+      }
+
+      const MontgomeryPoint next = add(cur, qD, prev);
+      prev = cur;
+      cur = next;
+      ++k;
+    }
+
+    return 1U;
+  }
+
+private:
+  const Montgomery &mont;
+  // (A + 2) / 4
+  BigInteger a24;
+};
+
+// Suggested ECM stage 1 bound and curve count, to find a factor of up to "digits" decimal digits with high probability.
+// (These follow the widely used GMP-ECM table, with stage 2 at 100 times the stage 1 bound.)
+void ecmParameters(size_t digits, size_t &b1, size_t &curveCount) {
+  static const size_t table[][3U] = {
+    {15U, 2000U, 25U}, {20U, 11000U, 90U}, {25U, 50000U, 300U}, {30U, 250000U, 700U},
+    {35U, 1000000U, 1800U}, {40U, 3000000U, 5100U}, {45U, 11000000U, 10600U}, {50U, 43000000U, 19300U}
+  };
+  for (const auto &row : table) {
+    b1 = row[1U];
+    curveCount = row[2U];
+    if (digits <= row[0U]) {
+      break;
+    }
+  }
+}
+
+// Lenstra's elliptic curve method: one curve per thread at a time, on the dispatch pool, until a factor is found or curveCount
+// curves have been tried. The first factor found stops every other curve at its next check. Returns 1 if it finds no nontrivial factor.
+// Nodes split the curves, with sigma = 6 + nodeId + nodeCount * curve on this node, for its share of curveCount.
+BigInteger ecm(const BigInteger &n, size_t b1, size_t b2, size_t curveCount, size_t nodeCount = 1U, size_t nodeId = 0U) {
+  if (!(n & 1U)) {
+    return 2U;
+  }
+  if (!(n % 3U)) {
+    return 3U;
+  }
+  if (b2 < b1) {
+    b2 = b1;
+  }
+
+  const Montgomery mont(n);
+  const std::vector<size_t> primes = SieveOfEratosthenes(b2);
+  const size_t b1Count = std::distance(primes.begin(), std::upper_bound(primes.begin(), primes.end(), b1));
+  curveCount = (curveCount + nodeCount - 1U - nodeId) / nodeCount;
+
+  std::atomic<bool> found(false);
+  std::atomic<size_t> nextCurve(0U);
+  BigInteger result = 1U;
+  std::mutex resultMutex;
+  for (unsigned cpu = 0U; cpu < CpuCount; ++cpu) {
+    dispatch.dispatch([&]() -> bool {
+      for (size_t curve = nextCurve++; (curve < curveCount) && !found.load(std::memory_order_relaxed); curve = nextCurve++) {
+        BigInteger g;
+        const EllipticCurve ec(mont, 6U + nodeId + nodeCount * curve, g);
+        if (g == 1U) {
+          g = ec.factor(primes, b1Count, b1, found);
+        }
+        if ((g != 1U) && (g != n)) {
+          std::lock_guard<std::mutex> lock(resultMutex);
+          if (result == 1U) {
+            result = g;
+          }
+          found.store(true, std::memory_order_relaxed);
+        }
+      }
+      // (Returning true would stop the dispatch queue for good.)
+      return false;
+    });
+  }
+  dispatch.finish();
+
+  return result;
+}
+
+inline uint64_t isqrt64(uint64_t n) {
+  uint64_t r = (uint64_t)std::sqrt((double)n);
+  // (The double-precision estimate can be off by one, either way, above 2^52.)
+  while (r && ((r * r) > n)) {
+    --r;
+  }
+  while (((r + 1U) * (r + 1U)) <= n) {
+    ++r;
+  }
+
+  return r;
+}
+
+inline uint64_t gcd64(uint64_t a, uint64_t b) {
+  while (b) {
+    const uint64_t t = a % b;
+    a = b;
+    b = t;
+  }
+
+  return a;
+}
+
+inline bool isSquare64(uint64_t n, uint64_t &root) {
+  // Squares are only 12 of the 64 residues modulo 64.
+  if (!((0x0202021202030213ULL >> (n & 63U)) & 1U)) {
+    return false;
+  }
+  root = isqrt64(n);
+
+  return (root * root) == n;
+}
+
+// Below this, hartLehman() factors on the calling thread, with no allocation.
+constexpr uint64_t HartLehmanLimit = 1ULL << 42U;
+
+// Square roots of 0 through the cube root of HartLehmanLimit, for sqrt(kn) = sqrt(k) sqrt(n).
+const std::vector<double> &sqrtTable() {
+  static const std::vector<double> table = [] {
+    std::vector<double> t((1U << 14U) + 2U);
+    for (size_t k = 0U; k < t.size(); ++k) {
+      t[k] = std::sqrt((double)k);
+    }
+    return t;
+  }();
+
+  return table;
+}
+
+// Hart's one-line factoring algorithm, with trial division interleaved, up to the cube root of n,
+// then Lehman's method, which is certain to find a factor of any composite n that survives that far.
+// For n below 2^42, in native integers. Returns a nontrivial factor, or 1 if n is prime.
+uint64_t hartLehman(uint64_t n) {
+  if (n < 4U) {
+    return 1U;
+  }
+  if (!(n & 1U)) {
+    return 2U;
+  }
+  uint64_t root;
+  if (isSquare64(n, root)) {
+    return root;
+  }
+
+  const std::vector<double> &sqrtK = sqrtTable();
+  const double sqrtN = std::sqrt((double)n);
+  uint64_t cubeRoot = (uint64_t)std::cbrt((double)n);
+  while (((cubeRoot + 1U) * (cubeRoot + 1U) * (cubeRoot + 1U)) <= n) {
+    ++cubeRoot;
+  }
+
+  // Hart: s = ceil(sqrt(in)), and if s^2 mod n is a square t^2, then gcd(s - t, n) is likely a factor.
+  // (Trial division by 2i + 1 rides along, since Hart is slow for small factors, and Lehman needs them gone.)
+  for (uint64_t i = 1U; i <= cubeRoot; ++i) {
+    const uint64_t d = (i << 1U) + 1U;
+    if (!(n % d)) {
+      return d;
+    }
+    const uint64_t in = i * n;
+    uint64_t s = (uint64_t)std::ceil(sqrtN * sqrtK[i]);
+    while ((s * s) < in) {
+      ++s;
+    }
+    while ((s > 1U) && (((s - 1U) * (s - 1U)) >= in)) {
+      --s;
+    }
+    uint64_t t;
+    if (isSquare64((s * s) % n, t)) {
+      const uint64_t f = gcd64(s - t, n);
+      if ((f != 1U) && (f != n)) {
+        return f;
+      }
+    }
+  }
+
+  // Lehman: for some k up to the cube root, a^2 - 4kn = b^2 for a near sqrt(4kn), and then gcd(a + b, n) is a factor.
+  for (uint64_t k = 1U; k <= cubeRoot; ++k) {
+    const uint64_t fourKN = (k * n) << 2U;
+    const double sqrt4kn = 2.0 * sqrtN * sqrtK[k];
+    uint64_t a = (uint64_t)std::ceil(sqrt4kn);
+    while ((a * a) < fourKN) {
+      ++a;
+    }
+    const uint64_t aMax = (uint64_t)(sqrt4kn + std::pow((double)n, 1.0 / 6.0) / (4.0 * sqrtK[k]));
+    for (; a <= aMax; ++a) {
+      uint64_t b;
+      if (isSquare64((a * a) - fourKN, b)) {
+        const uint64_t f = gcd64(a + b, n);
+        if ((f != 1U) && (f != n)) {
+          return f;
+        }
+      }
+    }
+  }
+
+  return 1U;
+}
+
+// One multiplier's run of Shanks' square forms factorization (SQUFOF) on kN, in native 64-bit arithmetic.
+class SqufofRace {
+public:
+  SqufofRace(uint64_t n, uint64_t k) : n_(n), kN_(n * k), isDone_(false), i_(1U) {
+    p0_ = isqrt64(kN_);
+    p_ = p0_;
+    qPrev_ = 1U;
+    q_ = kN_ - p0_ * p0_;
+    // The forward cycle is expected to find a square within about sqrt(2 sqrt(kN)) steps.
+    limit_ = 6U * isqrt64(2U * p0_);
+    if (!q_) {
+      isDone_ = true;
+    }
+  }
+
+  bool isDone() const { return isDone_; }
+
+  // Advance the forward cycle by up to "steps" forms. Returns a nontrivial factor of n, or 0 if there is none yet.
+  uint64_t advance(size_t steps) {
+    for (; steps && !isDone_; --steps) {
+      if (++i_ > limit_) {
+        isDone_ = true;
+        break;
+      }
+      const uint64_t b = (p0_ + p_) / q_;
+      const uint64_t p = b * q_ - p_;
+      const uint64_t q = qPrev_ + b * (p_ - p);
+      qPrev_ = q_;
+      q_ = q;
+      p_ = p;
+      if (i_ & 1U) {
+        continue;
+      }
+      const uint64_t r = isqrt64(q_);
+      if ((r * r) != q_) {
+        continue;
+      }
+      const uint64_t f = reverse(r);
+      if (f) {
+        isDone_ = true;
+        return f;
+      }
+      // (An improper square form only gives a trivial factor, so keep going.)
+    }
+
+    return 0U;
+  }
+
+private:
+  uint64_t n_, kN_, p0_, p_, q_, qPrev_, limit_;
+  bool isDone_;
+  size_t i_;
+
+  // Reverse cycle from the square form with root r, to the symmetry point, where P repeats.
+  uint64_t reverse(uint64_t r) const {
+    const uint64_t b0 = (p0_ - p_) / r;
+    uint64_t p = b0 * r + p_;
+    uint64_t pPrev;
+    uint64_t qPrev = r;
+    uint64_t q = (kN_ - p * p) / qPrev;
+    for (size_t j = 0U; j < limit_; ++j) {
+      const uint64_t b = (p0_ + p) / q;
+      pPrev = p;
+      p = b * q - p;
+      const uint64_t t = q;
+      q = qPrev + b * (pPrev - p);
+      qPrev = t;
+      if (p == pPrev) {
+        const uint64_t f = gcd64(n_, p);
+        return ((f != 1U) && (f != n_)) ? f : 0U;
+      }
+    }
+
+    return 0U;
+  }
+};
+
+// Shanks' square forms factorization for n below 2^62, racing several multipliers k (with kN below 2^62)
+// round-robin, in native 64-bit arithmetic, on the calling thread. This also splits small composite cofactors.
+// Returns a nontrivial factor, or 1 if n is prime, or if every multiplier fails.
+uint64_t squfof(uint64_t n) {
+  constexpr uint64_t squfofLimit = 1ULL << 62U;
+  static const uint64_t multipliers[] = {1U, 3U, 5U, 7U, 11U, 15U, 21U, 33U, 35U, 55U, 77U, 105U, 165U, 231U, 385U, 1155U};
+  if (n < 4U) {
+    return 1U;
+  }
+  // (SQUFOF can't split a factor that the multiplier shares, or a square.)
+  for (const uint64_t p : {2U, 3U, 5U, 7U, 11U}) {
+    if (!(n % p)) {
+      return (n == p) ? 1U : p;
+    }
+  }
+  const uint64_t r = isqrt64(n);
+  if ((r * r) == n) {
+    return r;
+  }
+
+  std::vector<SqufofRace> races;
+  for (const uint64_t k : multipliers) {
+    if (n < (squfofLimit / k)) {
+      races.emplace_back(n, k);
+    }
+  }
+  bool isRunning = true;
+  while (isRunning) {
+    isRunning = false;
+    for (SqufofRace &race : races) {
+      if (race.isDone()) {
+        continue;
+      }
+      isRunning = true;
+      const uint64_t f = race.advance(64U);
+      if (f) {
+        return f;
+      }
+    }
+  }
+
+  return 1U;
+}
+
+// General number field sieve (method 8), with a base-m polynomial of odd degree d:
+// f(x) = x^d + c_(d-1) x^(d-1) + ... + c_0, with f(m) = N, where m is about N^(1/d).
+// A relation is a coprime pair (a, b), with b > 0, where both a - bm and F(a, b) = b^d f(a/b) are smooth.
+// (Odd degree is what lets the algebraic square root be taken in a single inert prime, below.)
+
+// An element of Z[alpha], for a root alpha of f, as its coefficients of 1, alpha, ..., alpha^(d-1)
+typedef std::vector<BigInteger> GnfsElement;
+
+// Multiply in Z[x] / (f), for monic f (given as coefficients of 1, x, ..., x^d),
+// reducing every coefficient into [0, modulus), unless modulus is 0.
+GnfsElement gnfsMultiply(const GnfsElement &x, const GnfsElement &y, const std::vector<BigInteger> &f, const BigInteger &modulus) {
+  const size_t d = f.size() - 1U;
+  std::vector<BigInteger> t(2U * d - 1U, 0U);
+  for (size_t i = 0U; i < d; ++i) {
+    if (!x[i]) {
+      continue;
+    }
+    for (size_t j = 0U; j < d; ++j) {
+      t[i + j] += x[i] * y[j];
+    }
+  }
+  // alpha^d = -(c_0 + c_1 alpha + ... + c_(d-1) alpha^(d-1))
+  for (size_t i = 2U * d - 2U; i >= d; --i) {
+    if (modulus) {
+      t[i] %= modulus;
+    }
+    const BigInteger c = t[i];
+    if (!c) {
+      continue;
+    }
+    for (size_t j = 0U; j < d; ++j) {
+      t[i - d + j] -= c * f[j];
+    }
+  }
+  t.resize(d);
+  if (modulus) {
+    for (BigInteger &c : t) {
+      c %= modulus;
+      if (c < 0) {
+        c += modulus;
+      }
+    }
+  }
+
+  return t;
+}
+
+GnfsElement gnfsPow(GnfsElement base, BigInteger exponent, const std::vector<BigInteger> &f, const BigInteger &modulus) {
+  GnfsElement result(f.size() - 1U, 0U);
+  result[0U] = 1U;
+  while (exponent) {
+    if (exponent & 1U) {
+      result = gnfsMultiply(result, base, f, modulus);
+    }
+    exponent >>= 1U;
+    if (exponent) {
+      base = gnfsMultiply(base, base, f, modulus);
+    }
+  }
+
+  return result;
+}
+
+// Whether two polynomials (coefficients of 1, x, x^2, ...) share a nonconstant factor modulo a prime p
+bool gnfsHasCommonFactor(std::vector<BigInteger> g, std::vector<BigInteger> h, const BigInteger &p) {
+  const auto trim = [](std::vector<BigInteger> &v) {
+    while ((v.size() > 1U) && !v.back()) {
+      v.pop_back();
+    }
+  };
+  const auto isZero = [](const std::vector<BigInteger> &v) { return (v.size() == 1U) && !v[0U]; };
+  for (BigInteger &c : g) {
+    c = ((c % p) + p) % p;
+  }
+  for (BigInteger &c : h) {
+    c = ((c % p) + p) % p;
+  }
+  trim(g);
+  trim(h);
+  while (!isZero(h)) {
+    const BigInteger inv = modInverse(h.back(), p);
+    while (!isZero(g) && (g.size() >= h.size())) {
+      const size_t shift = g.size() - h.size();
+      const BigInteger c = (g.back() * inv) % p;
+      for (size_t j = 0U; j < h.size(); ++j) {
+        BigInteger &t = g[shift + j];
+        t = (t - c * h[j]) % p;
+        if (t < 0) {
+          t += p;
+        }
+      }
+      g.pop_back();
+      if (g.empty()) {
+        g.push_back(0U);
+      }
+      trim(g);
+    }
+    std::swap(g, h);
+  }
+
+  return g.size() > 1U;
+}
+
+inline size_t powMod(size_t base, size_t exponent, size_t p) {
+  size_t result = 1U;
+  base %= p;
+  while (exponent) {
+    if (exponent & 1U) {
+      result = mulMod(result, base, p);
+    }
+    base = mulMod(base, base, p);
+    exponent >>= 1U;
+  }
+
+  return result;
+}
+
+// Line sieving and relations, over a rational factor base of primes p (with a - bm = 0 mod p when a = bm mod p),
+// and an algebraic factor base of degree-one prime ideals (p, r), for each root r of f mod p (with F(a, b) = 0 mod p when a = br mod p).
+// Quadratic characters (q, s), for primes q above the factor base bound, make a product of relations that is a square
+// in both factor bases very likely to be a square in Z[alpha], too.
+class GnfsSieve {
+public:
+  const BigInteger &n;
+  BigInteger m;
+  // Coefficients of 1, x, ..., x^d (so the last is 1)
+  std::vector<BigInteger> f;
+  std::vector<size_t> rationalPrimes;
+  std::vector<size_t> idealPrimes;
+  std::vector<size_t> idealRoots;
+  std::vector<size_t> characterPrimes;
+  std::vector<size_t> characterRoots;
+  std::vector<std::pair<int64_t, uint64_t>> relations;
+  std::vector<boost::dynamic_bitset<size_t>> relationRows;
+
+  GnfsSieve(const BigInteger &toFactor, size_t degree, size_t bound, int64_t sieveRadius)
+    : n(toFactor)
+    , radius(sieveRadius)
+  {
+    // m = floor(N^(1/d)), by Newton's method from above
+    m = ((BigInteger)1U) << ((msb(n) / degree) + 1U);
+    while (true) {
+      BigInteger power = 1U;
+      for (size_t i = 1U; i < degree; ++i) {
+        power *= m;
+      }
+      const BigInteger next = ((degree - 1U) * m + n / power) / degree;
+      if (next >= m) {
+        break;
+      }
+      m = next;
+    }
+    // Base-m digits of N, balanced into (-m/2, m/2] below the leading two, to shrink the algebraic norms
+    BigInteger r = n;
+    f.resize(degree + 1U);
+    for (size_t i = 0U; i < degree; ++i) {
+      f[i] = r % m;
+      r /= m;
+    }
+    f[degree] = r;
+    for (size_t i = 0U; (i + 2U) < degree; ++i) {
+      if ((f[i] << 1U) > m) {
+        f[i] -= m;
+        ++f[i + 1U];
+      }
+    }
+    for (const BigInteger &c : f) {
+      fDouble.push_back(c.convert_to<double>());
+    }
+    mDouble = m.convert_to<double>();
+
+    const std::vector<size_t> primes = SieveOfEratosthenes(bound + (bound >> 2U) + 4096U);
+    for (const size_t &p : primes) {
+      if (p > bound) {
+        break;
+      }
+      rationalPrimes.push_back(p);
+      mModP.push_back((size_t)(m % p));
+    }
+
+    // Roots of f mod p, by brute force, with the primes split over the thread pool
+    std::vector<std::vector<size_t>> roots(rationalPrimes.size());
+    const size_t slice = (rationalPrimes.size() + CpuCount - 1U) / CpuCount;
+    for (size_t start = 0U; start < rationalPrimes.size(); start += slice) {
+      dispatch.dispatch([this, &roots, start, slice]() -> bool {
+        const size_t end = std::min(start + slice, rationalPrimes.size());
+        for (size_t i = start; i < end; ++i) {
+          roots[i] = rootsModP(rationalPrimes[i]);
+        }
+        return false;
+      });
+    }
+    dispatch.finish();
+    for (size_t i = 0U; i < rationalPrimes.size(); ++i) {
+      for (const size_t &root : roots[i]) {
+        idealPrimes.push_back(rationalPrimes[i]);
+        idealRoots.push_back(root);
+      }
+    }
+
+    // Characters are roots of f (but not of f') modulo primes above the bound.
+    const size_t characterCount = 32U;
+    for (size_t i = rationalPrimes.size(); (i < primes.size()) && (characterPrimes.size() < characterCount); ++i) {
+      const size_t q = primes[i];
+      for (const size_t &s : rootsModP(q)) {
+        if (!derivativeModP(s, q) || (characterPrimes.size() >= characterCount)) {
+          continue;
+        }
+        characterPrimes.push_back(q);
+        characterRoots.push_back(s);
+      }
+    }
+  }
+
+  size_t degree() const { return f.size() - 1U; }
+
+  // Columns are the sign of a - bm, the rational primes, the algebraic ideals, and the quadratic characters.
+  size_t columnCount() const { return 1U + rationalPrimes.size() + idealPrimes.size() + characterPrimes.size(); }
+
+  // Sieve lines 1 + nodeId + nodeCount * t, for t = 0, 1, 2, ..., on every thread, until there are "target" relations.
+  // Returns the number of lines sieved.
+  size_t sieve(size_t target, size_t nodeCount, size_t nodeId) {
+    std::atomic<size_t> nextLine(0U);
+    std::atomic<bool> isDone(relations.size() >= target);
+    std::mutex relationMutex;
+    for (unsigned cpu = 0U; cpu < CpuCount; ++cpu) {
+      dispatch.dispatch([this, target, nodeCount, nodeId, &nextLine, &isDone, &relationMutex]() -> bool {
+        std::vector<uint8_t> rationalLogs(2U * (size_t)radius + 1U);
+        std::vector<uint8_t> algebraicLogs(2U * (size_t)radius + 1U);
+        std::vector<std::pair<int64_t, uint64_t>> found;
+        std::vector<boost::dynamic_bitset<size_t>> rows;
+        while (!isDone.load(std::memory_order_relaxed)) {
+          sieveLine(1U + nodeId + nodeCount * nextLine++, rationalLogs, algebraicLogs, found, rows);
+          if (found.empty()) {
+            continue;
+          }
+          std::lock_guard<std::mutex> lock(relationMutex);
+          relations.insert(relations.end(), found.begin(), found.end());
+          relationRows.insert(relationRows.end(), rows.begin(), rows.end());
+          found.clear();
+          rows.clear();
+          if (relations.size() >= target) {
+            isDone = true;
+          }
+        }
+        return false;
+      });
+    }
+    dispatch.finish();
+
+    return nextLine;
+  }
+
+  // Factor both norms of (a, b) over the factor bases, and set its column parities in "row."
+  // The exponents of the rational primes are added to "exponents," if it isn't null.
+  // Returns false if either norm is not smooth.
+  bool factorRelation(int64_t a, uint64_t b, boost::dynamic_bitset<size_t> &row, std::vector<size_t> *exponents) const {
+    row.resize(columnCount());
+    row.reset();
+    BigInteger rational = a - b * m;
+    BigInteger algebraic = 0U;
+    BigInteger aPower = 1U;
+    BigInteger bPower = 1U;
+    for (size_t i = 0U; i < degree(); ++i) {
+      bPower *= b;
+    }
+    for (size_t i = 0U; i <= degree(); ++i) {
+      algebraic += f[i] * aPower * bPower;
+      aPower *= a;
+      if (i < degree()) {
+        bPower /= b;
+      }
+    }
+    if (!rational || !algebraic) {
+      return false;
+    }
+    if (rational < 0) {
+      row[0U] = true;
+      rational = -rational;
+    }
+    if (algebraic < 0) {
+      algebraic = -algebraic;
+    }
+
+    size_t column = 1U;
+    for (size_t i = 0U; i < rationalPrimes.size(); ++i, ++column) {
+      const size_t &p = rationalPrimes[i];
+      if (residue(a, p) != mulMod(b % p, mModP[i], p)) {
+        continue;
+      }
+      size_t e = 0U;
+      while (!(rational % p)) {
+        rational /= p;
+        ++e;
+      }
+      row[column] = e & 1U;
+      if (exponents) {
+        (*exponents)[i] += e;
+      }
+    }
+    if (rational != 1U) {
+      return false;
+    }
+
+    // Since gcd(a, b) = 1, a prime that divides b never divides F(a, b),
+    // and a prime that does divides it at exactly one of its ideals.
+    for (size_t i = 0U; i < idealPrimes.size(); ++i, ++column) {
+      const size_t &p = idealPrimes[i];
+      if (!(b % p) || (residue(a, p) != mulMod(b % p, idealRoots[i], p))) {
+        continue;
+      }
+      size_t e = 0U;
+      while (!(algebraic % p)) {
+        algebraic /= p;
+        ++e;
+      }
+      row[column] = e & 1U;
+    }
+    if (algebraic != 1U) {
+      return false;
+    }
+
+    // A square's image (a - bs) mod q is a quadratic residue, for every character.
+    for (size_t i = 0U; i < characterPrimes.size(); ++i, ++column) {
+      const size_t &q = characterPrimes[i];
+      const size_t v = (residue(a, q) + q - mulMod(b % q, characterRoots[i], q)) % q;
+      row[column] = v && (powMod(v, (q - 1U) >> 1U, q) != 1U);
+    }
+
+    return true;
+  }
+
+private:
+  int64_t radius;
+  double mDouble;
+  std::vector<double> fDouble;
+  std::vector<size_t> mModP;
+
+  static size_t residue(int64_t a, size_t p) {
+    const int64_t r = a % (int64_t)p;
+    return (size_t)((r < 0) ? (r + (int64_t)p) : r);
+  }
+
+  size_t derivativeModP(size_t x, size_t p) const {
+    size_t v = 0U;
+    for (size_t i = degree(); i > 0U; --i) {
+      v = (mulMod(v, x, p) + (size_t)((((f[i] * i) % p) + p) % p)) % p;
+    }
+
+    return v;
+  }
+
+  std::vector<size_t> rootsModP(size_t p) const {
+    std::vector<size_t> coefficients(degree() + 1U);
+    for (size_t i = 0U; i <= degree(); ++i) {
+      coefficients[i] = (size_t)(((f[i] % p) + p) % p);
+    }
+    std::vector<size_t> result;
+    for (size_t x = 0U; x < p; ++x) {
+      size_t v = 0U;
+      for (size_t i = degree() + 1U; i-- > 0U;) {
+        v = (mulMod(v, x, p) + coefficients[i]) % p;
+      }
+      if (!v) {
+        result.push_back(x);
+      }
+    }
+
+    return result;
+  }
+
+  // Sieve a from -radius to radius, for one b, with rounded base-2 logarithms on both sides,
+  // and then check every survivor by trial division.
+  void sieveLine(uint64_t b, std::vector<uint8_t> &rationalLogs, std::vector<uint8_t> &algebraicLogs,
+                 std::vector<std::pair<int64_t, uint64_t>> &found, std::vector<boost::dynamic_bitset<size_t>> &rows) const {
+    // The smallest primes aren't sieved (they cost the most, and add the least), so thresholds leave room for them.
+    const size_t smallPrime = 30U;
+    const size_t width = 2U * (size_t)radius + 1U;
+    std::fill(rationalLogs.begin(), rationalLogs.end(), 0U);
+    std::fill(algebraicLogs.begin(), algebraicLogs.end(), 0U);
+    for (size_t i = 0U; i < rationalPrimes.size(); ++i) {
+      const size_t &p = rationalPrimes[i];
+      if (p < smallPrime) {
+        continue;
+      }
+      const uint8_t logP = (uint8_t)(std::log2((double)p) + 0.5);
+      // a = -radius + offset = bm (mod p)
+      for (size_t offset = (mulMod(b % p, mModP[i], p) + (size_t)radius) % p; offset < width; offset += p) {
+        rationalLogs[offset] += logP;
+      }
+    }
+    for (size_t i = 0U; i < idealPrimes.size(); ++i) {
+      const size_t &p = idealPrimes[i];
+      if ((p < smallPrime) || !(b % p)) {
+        continue;
+      }
+      const uint8_t logP = (uint8_t)(std::log2((double)p) + 0.5);
+      for (size_t offset = (mulMod(b % p, idealRoots[i], p) + (size_t)radius) % p; offset < width; offset += p) {
+        algebraicLogs[offset] += logP;
+      }
+    }
+
+    const double slack = std::log2((double)rationalPrimes.back()) + 8.0;
+    const double rationalThreshold = std::log2((double)b * mDouble + (double)radius) - slack;
+    // c_i b^(d - i), for the algebraic norm F(a, b) of each survivor, as a polynomial in a
+    std::vector<double> lineCoefficients(degree() + 1U);
+    double bPower = 1.0;
+    for (size_t i = degree() + 1U; i-- > 0U;) {
+      lineCoefficients[i] = fDouble[i] * bPower;
+      bPower *= (double)b;
+    }
+    boost::dynamic_bitset<size_t> row;
+    for (size_t offset = 0U; offset < width; ++offset) {
+      if (rationalLogs[offset] < rationalThreshold) {
+        continue;
+      }
+      const int64_t a = (int64_t)offset - radius;
+      double norm = 0.0;
+      for (size_t i = degree() + 1U; i-- > 0U;) {
+        norm = norm * a + lineCoefficients[i];
+      }
+      if ((algebraicLogs[offset] < (std::log2(std::abs(norm) + 1.0) - slack)) || (gcd64((uint64_t)std::abs(a), b) != 1U)) {
+        continue;
+      }
+      if (factorRelation(a, b, row, nullptr)) {
+        found.emplace_back(a, b);
+        rows.push_back(row);
+      }
+    }
+  }
+};
+
+// The square root of a dependency: Y^2 = f'(m)^2 * product of (a - bm), on the rational side, and
+// X^2 = the image at m of f'(alpha)^2 * product of (a - b alpha), on the algebraic side, so gcd(X - Y, N) might be a factor.
+// The algebraic square root is lifted p-adically, by Newton's method, from a square root in the finite field Z[alpha] / (p),
+// for a prime p = 3 (mod 4) where f is irreducible, and is then checked exactly. Returns 1 if the dependency fails.
+BigInteger gnfsSquareRoot(const GnfsSieve &sieve, const std::vector<size_t> &dependency) {
+  const BigInteger &n = sieve.n;
+  const std::vector<BigInteger> &f = sieve.f;
+  const size_t d = sieve.degree();
+
+  // Rational side
+  std::vector<size_t> exponents(sieve.rationalPrimes.size(), 0U);
+  boost::dynamic_bitset<size_t> row;
+  bool isNegative = false;
+  for (const size_t &i : dependency) {
+    sieve.factorRelation(sieve.relations[i].first, sieve.relations[i].second, row, &exponents);
+    isNegative ^= row[0U];
+  }
+  if (isNegative) {
+    return 1U;
+  }
+  BigInteger derivativeAtM = 0U;
+  for (size_t i = d; i > 0U; --i) {
+    derivativeAtM = (derivativeAtM * sieve.m + f[i] * i) % n;
+  }
+  BigInteger y = (derivativeAtM < 0) ? (BigInteger)(derivativeAtM + n) : derivativeAtM;
+  for (size_t i = 0U; i < exponents.size(); ++i) {
+    if (exponents[i] & 1U) {
+      return 1U;
+    }
+    if (exponents[i]) {
+      y = (y * mod_exp(sieve.rationalPrimes[i], exponents[i] >> 1U, n)) % n;
+    }
+  }
+
+  // Algebraic side: delta = f'(alpha)^2 * product of (a - b alpha), by a product tree
+  std::vector<GnfsElement> terms;
+  terms.reserve(dependency.size() + 2U);
+  GnfsElement derivative(d, 0U);
+  for (size_t i = 1U; i <= d; ++i) {
+    derivative[i - 1U] = f[i] * i;
+  }
+  terms.push_back(derivative);
+  terms.push_back(derivative);
+  for (const size_t &i : dependency) {
+    GnfsElement term(d, 0U);
+    term[0U] = sieve.relations[i].first;
+    if (d > 1U) {
+      term[1U] = -(BigInteger)sieve.relations[i].second;
+    }
+    terms.push_back(term);
+  }
+  while (terms.size() > 1U) {
+    std::vector<GnfsElement> next;
+    next.reserve((terms.size() + 1U) >> 1U);
+    for (size_t i = 0U; (i + 1U) < terms.size(); i += 2U) {
+      next.push_back(gnfsMultiply(terms[i], terms[i + 1U], f, 0U));
+    }
+    if (terms.size() & 1U) {
+      next.push_back(terms.back());
+    }
+    terms.swap(next);
+  }
+  const GnfsElement delta = terms[0U];
+  size_t deltaBits = 0U;
+  for (const BigInteger &c : delta) {
+    if (c) {
+      deltaBits = std::max(deltaBits, (size_t)msb((c < 0) ? (BigInteger)(-c) : c));
+    }
+  }
+
+  // An inert prime, where F_p[x] / (f) is the field with p^d elements
+  // (f divides x^(p^d) - x, and shares no factor with x^p - x, so, for prime d, it's irreducible).
+  GnfsElement x(d, 0U);
+  if (d > 1U) {
+    x[1U] = 1U;
+  }
+  BigInteger p = 0U;
+  for (size_t candidate = 0x7FFFFFFFU; candidate > 0x40000000U; candidate -= 4U) {
+    bool isPrime = true;
+    for (size_t divisor = 3U; (divisor * divisor) <= candidate; divisor += 2U) {
+      if (!(candidate % divisor)) {
+        isPrime = false;
+        break;
+      }
+    }
+    if (!isPrime || !(n % candidate)) {
+      continue;
+    }
+    GnfsElement xp = gnfsPow(x, candidate, f, candidate);
+    if (gnfsPow(x, pow((BigInteger)candidate, (unsigned)d), f, candidate) != x) {
+      continue;
+    }
+    std::vector<BigInteger> g(xp.begin(), xp.end());
+    g[1U] -= 1U;
+    if (!gnfsHasCommonFactor(g, f, candidate)) {
+      p = candidate;
+      break;
+    }
+  }
+  if (!p) {
+    return 1U;
+  }
+
+  // Square root in the field, with (p^d + 1) / 4 as the exponent, since p^d = 3 (mod 4) for odd d
+  const BigInteger fieldOrder = pow(p, (unsigned)d);
+  GnfsElement deltaModP = delta;
+  for (BigInteger &c : deltaModP) {
+    c = ((c % p) + p) % p;
+  }
+  const GnfsElement root = gnfsPow(deltaModP, (fieldOrder + 1U) >> 2U, f, p);
+  if (gnfsMultiply(root, root, f, p) != deltaModP) {
+    return 1U;
+  }
+
+  // Newton's method for z = delta^(-1/2), with z <- z (3 - delta z^2) / 2, doubling the p-adic precision every step
+  GnfsElement z = gnfsPow(root, fieldOrder - 2U, f, p);
+  BigInteger modulus = p;
+  while (true) {
+    modulus *= modulus;
+    GnfsElement deltaModulus = delta;
+    for (BigInteger &c : deltaModulus) {
+      c = ((c % modulus) + modulus) % modulus;
+    }
+    GnfsElement t = gnfsMultiply(deltaModulus, gnfsMultiply(z, z, f, modulus), f, modulus);
+    for (BigInteger &c : t) {
+      c = (modulus - c) % modulus;
+    }
+    t[0U] = (t[0U] + 3U) % modulus;
+    z = gnfsMultiply(z, t, f, modulus);
+    const BigInteger half = (modulus + 1U) >> 1U;
+    for (BigInteger &c : z) {
+      c = (c * half) % modulus;
+    }
+    if ((size_t)msb(modulus) < ((deltaBits >> 1U) + 2U)) {
+      continue;
+    }
+    // gamma = delta z is delta^(1/2), to this precision, so it's exact once its coefficients fit (with sign).
+    GnfsElement gamma = gnfsMultiply(deltaModulus, z, f, modulus);
+    for (BigInteger &c : gamma) {
+      if ((c << 1U) > modulus) {
+        c -= modulus;
+      }
+    }
+    if (gnfsMultiply(gamma, gamma, f, 0U) == delta) {
+      BigInteger xm = 0U;
+      for (size_t i = d; i-- > 0U;) {
+        xm = (xm * sieve.m + gamma[i]) % n;
+      }
+      if (xm < 0) {
+        xm += n;
+      }
+      for (const BigInteger &candidate : { (BigInteger)(xm + n - y), (BigInteger)(xm + y) }) {
+        const BigInteger factor = gcd(candidate, n);
+        if ((factor > 1U) && (factor < n)) {
+          return factor;
+        }
+      }
+      return 1U;
+    }
+    if ((size_t)msb(modulus) > (deltaBits + 64U)) {
+      return 1U;
+    }
+  }
+}
+
+// Factor "n" by the general number field sieve, with "nodeCount" nodes splitting the sieve lines.
+// Zero for degree, bound, or radius picks a default for the size of n. Returns 1 if no dependency gives a factor.
+BigInteger gnfs(const BigInteger &n, size_t degree, size_t bound, size_t radius, size_t surplus, size_t nodeCount, size_t nodeId) {
+  const double logN = log(n.convert_to<double>());
+  if (!degree) {
+    degree = (logN < (90.0 * log(10.0))) ? 3U : 5U;
+  } else if (!(degree & 1U)) {
+    ++degree;
+    std::cout << "Warning: GNFS degree must be odd. (Defaulting to " << degree << ".)" << std::endl;
+  }
+  if (!bound) {
+    bound = std::max((size_t)2048U, (size_t)(2.5 * exp(0.5 * std::sqrt(logN * log(logN)))));
+  }
+  if (!radius) {
+    // (Every thread holds two bytes per sieve location.)
+    radius = std::min(100U * bound, (size_t)1U << 22U);
+  }
+
+  GnfsSieve sieve(n, degree, bound, (int64_t)radius);
+  // (A common factor of m and N would leave f with a root at 0.)
+  const BigInteger mFactor = gcd(sieve.m, n);
+  if ((mFactor > 1U) && (mFactor < n)) {
+    return mFactor;
+  }
+  const size_t columns = sieve.columnCount();
+  std::cout << "GNFS: degree " << degree << " polynomial with m = " << sieve.m << ", " << sieve.rationalPrimes.size() << " rational primes, "
+            << sieve.idealPrimes.size() << " algebraic ideals, and " << sieve.characterPrimes.size() << " quadratic characters." << std::endl;
+
+  // (Quadratic characters only make a dependency likely to be an algebraic square, so keep at least a few spare.)
+  surplus = std::max(surplus, (size_t)16U);
+  const size_t lines = sieve.sieve(columns + surplus, nodeCount, nodeId);
+  std::cout << "Sieved " << sieve.relations.size() << " relations over " << columns << " columns, from " << lines << " lines." << std::endl;
+
+  std::cout << "Filtering relations..." << std::endl;
+  const FilteredRelations relations(sieve.relationRows, columns, surplus);
+  std::cout << "Filtered " << sieve.relationRows.size() << " x " << columns << " relation matrix to " << relations.rows.size() << " x " << relations.columnCount << "." << std::endl;
+  // (The linear algebra only needs a host for the thread pool.)
+  Factorizer host(n, sqrt(n), 0U, 0U, 1U, 0U, 1U, relations.rows.size(), 0U, std::vector<size_t>(), forward(WHEEL1), backward(WHEEL1), 0U);
+  std::vector<std::vector<size_t>> solutions;
+  if (relations.columnCount > BlockLanczosThreshold) {
+    std::cout << "Performing Block Lanczos..." << std::endl;
+    solutions = relations.expand(host.blockLanczos(relations));
+  } else {
+    std::cout << "Performing Gaussian elimination..." << std::endl;
+    solutions = relations.expand(host.gaussianElimination(relations));
+  }
+
+  // Try every dependency on the thread pool, until one gives a nontrivial factor.
+  std::atomic<bool> isFound(false);
+  std::atomic<size_t> next(0U);
+  BigInteger result = 1U;
+  std::mutex resultMutex;
+  const size_t maxLcv = std::min((size_t)CpuCount, solutions.size());
+  for (size_t cpu = 0U; cpu < maxLcv; ++cpu) {
+    dispatch.dispatch([&sieve, &solutions, &isFound, &next, &result, &resultMutex]() -> bool {
+      for (size_t i = next++; (i < solutions.size()) && !isFound.load(std::memory_order_relaxed); i = next++) {
+        const BigInteger factor = gnfsSquareRoot(sieve, solutions[i]);
+        if (factor != 1U) {
+          std::lock_guard<std::mutex> lock(resultMutex);
+          result = factor;
+          isFound = true;
+        }
+      }
+      return false;
+    });
+  }
+  dispatch.finish();
+
+  return result;
+}
+
+// At most 15 distinct primes divide a 64-bit integer (since the product of the first 16 primes is above 2^64).
+constexpr size_t U64FactorSlots = 15U;
+
+// Multiplication modulo an odd 64-bit n, in Montgomery form where 128-bit integers are available (or else in plain form, with mulMod())
+struct Montgomery64 {
+  uint64_t n;
+  uint64_t nPrime;
+
+  Montgomery64(uint64_t modulus) : n(modulus), nPrime(0U) {
+#if defined(__SIZEOF_INT128__)
+    // -1 / n mod 2^64, by Newton's method (each step doubles the correct low bits)
+    uint64_t inv = n;
+    for (size_t k = 0U; k < 5U; ++k) {
+      inv *= 2U - n * inv;
+    }
+    nPrime = 0U - inv;
+#endif
+  }
+
+  uint64_t mul(uint64_t a, uint64_t b) const {
+#if defined(__SIZEOF_INT128__)
+    uint64_t r;
+    laneMontMul<1U>(&r, &a, &b, &n, nPrime);
+    return r;
+#else
+    return mulMod(a, b, n);
+#endif
+  }
+
+  uint64_t to(uint64_t a) const {
+#if defined(__SIZEOF_INT128__)
+    return (uint64_t)((((LaneWide)a) << 64U) % n);
+#else
+    return a % n;
+#endif
+  }
+
+  uint64_t add(uint64_t a, uint64_t b) const { return (a >= (n - b)) ? (a - (n - b)) : (a + b); }
+};
+
+// Deterministic Miller-Rabin for 64-bit n, with Jim Sinclair's seven bases, which leave no strong pseudoprime below 2^64
+// (or Jaeschke's three bases, below 4759123141).
+bool isPrime64(uint64_t n) {
+  static const std::vector<uint64_t> smallBases = {2U, 7U, 61U};
+  static const std::vector<uint64_t> bases = {2U, 325U, 9375U, 28178U, 450775U, 9780504U, 1795265022U};
+  if (n < 2U) {
+    return false;
+  }
+  for (const uint64_t p : {2U, 3U, 5U, 7U, 11U, 13U, 17U, 19U, 23U, 29U, 31U, 37U}) {
+    if (!(n % p)) {
+      return n == p;
+    }
+  }
+  uint64_t d = n - 1U;
+  size_t s = 0U;
+  while (!(d & 1U)) {
+    d >>= 1U;
+    ++s;
+  }
+  const Montgomery64 mont(n);
+  const uint64_t one = mont.to(1U);
+  const uint64_t minusOne = n - one;
+  for (const uint64_t &base : (n < 4759123141ULL) ? smallBases : bases) {
+    const uint64_t a = base % n;
+    if (!a) {
+      continue;
+    }
+    uint64_t x = one;
+    for (uint64_t b = mont.to(a), e = d; e; e >>= 1U) {
+      if (e & 1U) {
+        x = mont.mul(x, b);
+      }
+      b = mont.mul(b, b);
+    }
+    if ((x == one) || (x == minusOne)) {
+      continue;
+    }
+    bool isWitness = true;
+    for (size_t r = 1U; (r < s) && isWitness; ++r) {
+      x = mont.mul(x, x);
+      isWitness = (x != minusOne);
+    }
+    if (isWitness) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Brent's variant of Pollard's Rho, in native 64-bit arithmetic, for an odd composite n (on the calling thread).
+// Walks try c = 1, 2, 3, ... until one splits n, so this always returns a nontrivial factor.
+uint64_t pollardRho64(uint64_t n) {
+  const Montgomery64 mont(n);
+  for (uint64_t c = 1U;; ++c) {
+    // (On Montgomery representatives, c is just another constant.)
+    const auto step = [&mont, c](uint64_t y) { return mont.add(mont.mul(y, y), c); };
+    uint64_t x = 2U, y = 2U, ys = 2U, q = 1U, g = 1U;
+    for (size_t r = 1U; g == 1U; r <<= 1U) {
+      x = y;
+      for (size_t i = 0U; i < r; ++i) {
+        y = step(y);
+      }
+      for (size_t k = 0U; (k < r) && (g == 1U); k += 128U) {
+        ys = y;
+        const size_t batch = std::min((size_t)128U, r - k);
+        for (size_t i = 0U; i < batch; ++i) {
+          y = step(y);
+          q = mont.mul(q, (x > y) ? (x - y) : (y - x));
+        }
+        g = gcd64(q, n);
+      }
+    }
+    if (g == n) {
+      // Every factor turned up in the same batch, so step through it again, one GCD at a time.
+      do {
+        ys = step(ys);
+        g = gcd64((x > ys) ? (x - ys) : (ys - x), n);
+      } while (g == 1U);
+    }
+    if (g != n) {
+      return g;
+    }
+  }
+}
+
+// Full factorization of a 64-bit n, into U64FactorSlots slots of distinct primes (ascending) and their exponents,
+// with unused slots left 0. Small primes come off by trial division, and composite cofactors are split
+// by Hart and Lehman (below 2^42), SQUFOF (below 2^62), or Pollard's Rho, until every part is prime.
+void factorU64(uint64_t n, uint64_t *primes, uint8_t *exponents) {
+  // Odd primes below 1024, each with its inverse modulo 2^64 and the largest quotient, so p divides n exactly when n / p
+  // (as n times the inverse, modulo 2^64) is at most that quotient, with no division
+  struct SmallPrime {
+    uint64_t p;
+    uint64_t inverse;
+    uint64_t maxQuotient;
+  };
+  static const std::vector<SmallPrime> smallPrimes = [] {
+    std::vector<SmallPrime> table;
+    for (const size_t &p : SieveOfEratosthenes(1024U)) {
+      if (p == 2U) {
+        continue;
+      }
+      uint64_t inverse = p;
+      for (size_t k = 0U; k < 5U; ++k) {
+        inverse *= 2U - p * inverse;
+      }
+      table.push_back({ p, inverse, UINT64_MAX / p });
+    }
+    return table;
+  }();
+  std::fill(primes, primes + U64FactorSlots, 0U);
+  std::fill(exponents, exponents + U64FactorSlots, 0U);
+  // (0 and 1 have no prime factors.)
+  if (n < 2U) {
+    return;
+  }
+
+  // 64 prime factors, at most, with multiplicity
+  uint64_t found[64U];
+  size_t count = 0U;
+  while (!(n & 1U)) {
+    found[count++] = 2U;
+    n >>= 1U;
+  }
+  for (const SmallPrime &sp : smallPrimes) {
+    if ((sp.p * sp.p) > n) {
+      break;
+    }
+    for (uint64_t quotient = n * sp.inverse; quotient <= sp.maxQuotient; quotient = n * sp.inverse) {
+      found[count++] = sp.p;
+      n = quotient;
+    }
+  }
+  // (With no factor below 1024, any cofactor below 1024^2 is prime.)
+  const uint64_t primeBelow = 1U << 20U;
+  uint64_t composites[64U];
+  size_t top = 0U;
+  if (n > 1U) {
+    composites[top++] = n;
+  }
+  while (top) {
+    const uint64_t c = composites[--top];
+    if ((c < primeBelow) || isPrime64(c)) {
+      found[count++] = c;
+      continue;
+    }
+    uint64_t f = (c < HartLehmanLimit) ? hartLehman(c) : ((c < (1ULL << 62U)) ? squfof(c) : 1U);
+    if ((f == 1U) || (f == c)) {
+      f = pollardRho64(c);
+    }
+    composites[top++] = f;
+    composites[top++] = c / f;
+  }
+
+  std::sort(found, found + count);
+  size_t slot = 0U;
+  for (size_t i = 0U; i < count; ++i) {
+    if (i && (found[i] == found[i - 1U])) {
+      ++exponents[slot - 1U];
+      continue;
+    }
+    primes[slot] = found[i];
+    exponents[slot] = 1U;
+    ++slot;
+  }
+}
+
+// Factor "count" numbers, into rows of U64FactorSlots primes and exponents, with blocks of numbers claimed by every thread
+void factorU64Batch(const uint64_t *numbers, size_t count, uint64_t *primes, uint8_t *exponents) {
+  constexpr size_t blockSize = 1024U;
+  std::atomic<size_t> next(0U);
+  const size_t threadCount = std::min((size_t)CpuCount, (count + blockSize - 1U) / blockSize);
+  for (size_t cpu = 0U; cpu < threadCount; ++cpu) {
+    dispatch.dispatch([numbers, count, primes, exponents, &next]() -> bool {
+      for (size_t start = (next++) * blockSize; start < count; start = (next++) * blockSize) {
+        const size_t end = std::min(start + blockSize, count);
+        for (size_t i = start; i < end; ++i) {
+          factorU64(numbers[i], primes + i * U64FactorSlots, exponents + i * U64FactorSlots);
+        }
+      }
+      // (Returning true would stop the dispatch queue for good.)
+      return false;
+    });
+  }
+  dispatch.finish();
+}
+
+// Factor every integer in [first, first + count) by a segmented sieve, into rows of U64FactorSlots primes and exponents,
+// with the thread pool taking segments of "segmentSize" numbers. Each base prime (ascending, up to at least the square root
+// of the last number) is divided out of each of its multiples, and whatever remains above 1 is one more prime.
+void factorRangeWave(uint64_t first, size_t count, size_t segmentSize, const std::vector<size_t> &basePrimes, uint64_t *primes, uint8_t *exponents) {
+  std::atomic<size_t> next(0U);
+  const size_t segmentCount = (count + segmentSize - 1U) / segmentSize;
+  const size_t threadCount = std::min((size_t)CpuCount, segmentCount);
+  for (size_t cpu = 0U; cpu < threadCount; ++cpu) {
+    dispatch.dispatch([first, count, segmentSize, segmentCount, &basePrimes, primes, exponents, &next]() -> bool {
+      std::vector<uint64_t> remaining(segmentSize);
+      std::vector<uint8_t> slots(segmentSize);
+      for (size_t segment = next++; segment < segmentCount; segment = next++) {
+        const size_t offset = segment * segmentSize;
+        const size_t length = std::min(segmentSize, count - offset);
+        const uint64_t low = first + offset;
+        uint64_t *segmentPrimes = primes + offset * U64FactorSlots;
+        uint8_t *segmentExponents = exponents + offset * U64FactorSlots;
+        std::fill(segmentPrimes, segmentPrimes + length * U64FactorSlots, 0U);
+        std::fill(segmentExponents, segmentExponents + length * U64FactorSlots, 0U);
+        std::fill(slots.begin(), slots.end(), 0U);
+        for (size_t i = 0U; i < length; ++i) {
+          // (0 and 1 have no prime factors.)
+          remaining[i] = ((low + i) < 2U) ? 1U : (low + i);
+        }
+        const uint64_t high = low + (length - 1U);
+        for (const size_t &p : basePrimes) {
+          if (p > (high / p)) {
+            break;
+          }
+          for (size_t i = (p - (low % p)) % p; i < length; i += p) {
+            uint64_t &r = remaining[i];
+            if (r == 1U) {
+              continue;
+            }
+            uint8_t e = 0U;
+            while (!(r % p)) {
+              r /= p;
+              ++e;
+            }
+            segmentPrimes[i * U64FactorSlots + slots[i]] = p;
+            segmentExponents[i * U64FactorSlots + slots[i]] = e;
+            ++slots[i];
+          }
+        }
+        for (size_t i = 0U; i < length; ++i) {
+          if (remaining[i] > 1U) {
+            segmentPrimes[i * U64FactorSlots + slots[i]] = remaining[i];
+            segmentExponents[i * U64FactorSlots + slots[i]] = 1U;
+          }
+        }
+      }
+      // (Returning true would stop the dispatch queue for good.)
+      return false;
+    });
+  }
+  dispatch.finish();
+}
+
+// Load a relation matrix file, as a worker that is ready for linear algebra.
+std::unique_ptr<Factorizer> readRelationMatrix(const std::string &path, size_t &seed) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Could not open relation matrix file for reading: " + path);
+  }
+  if (readString(in) != RelationMatrixMagic) {
+    throw std::runtime_error("Not a FindAFactor relation matrix file: " + path);
+  }
+  const BigInteger toFactor(readString(in));
+  seed = readWord(in);
+  std::vector<size_t> smoothPrimes(readWord(in));
+  for (size_t &p : smoothPrimes) {
+    p = readWord(in);
+  }
+  const size_t rows = readWord(in);
+
+  std::unique_ptr<Factorizer> worker(new Factorizer(toFactor, sqrt(toFactor), 0U, 0U, 1U, 0U, 1U, rows, 0U, smoothPrimes, forward(WHEEL1), backward(WHEEL1), 0U));
+  for (size_t row = 0U; row < rows; ++row) {
+    worker->smoothNumberKeys.emplace_back(readString(in));
+    boost::dynamic_bitset<size_t> rfv(smoothPrimes.size(), 0U);
+    const size_t weight = readWord(in);
+    for (size_t i = 0U; i < weight; ++i) {
+      const size_t pid = readWord(in);
+      if (pid >= smoothPrimes.size()) {
+        throw std::runtime_error("Relation matrix file has a prime index out of range: " + path);
+      }
+      rfv.set(pid);
+    }
+    worker->smoothNumberValues.push_back(rfv);
+  }
+
+  return worker;
+}
 
-    return 1U;
-  }
+std::string krylovPartFile(const std::string &matrixFile, size_t partId) { return matrixFile + ".part" + std::to_string(partId); }
 
-  ////////////////////////////////////////////////////////////////////////////////////////////////////////////
-  //                              WRITTEN WITH HELP FROM ELARA (GPT) ABOVE                                  //
-  ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Compute one part of the Block Wiedemann Krylov sequence, from the shared relation matrix file,
+// and write it alongside that file. Parts need no communication with each other.
+void block_wiedemann_part(std::string matrixFile, size_t partId, size_t partCount) {
+  if (partId >= partCount) {
+    throw std::runtime_error("Block Wiedemann part ID must be less than part count!");
+  }
+  size_t seed;
+  const std::unique_ptr<Factorizer> worker = readRelationMatrix(matrixFile, seed);
+  // Filtering is deterministic, so every part (and the solve) sees the same filtered matrix.
+  const std::vector<BlockWord> sequence = worker->blockWiedemannPart(worker->filterRelations(), seed, partId, partCount);
+
+  const std::string path = krylovPartFile(matrixFile, partId);
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("Could not open Krylov sequence part file for writing: " + path);
+  }
+  writeString(out, KrylovPartMagic);
+  writeWord(out, seed);
+  writeWord(out, partId);
+  writeWord(out, partCount);
+  writeWord(out, sequence.size());
+  out.write(reinterpret_cast<const char *>(sequence.data()), sequence.size() * sizeof(BlockWord));
+  if (!out) {
+    throw std::runtime_error("Failed writing Krylov sequence part file: " + path);
+  }
+}
 
-  BigInteger solveForFactor() {
-    // Gaussian elimination is used to create a perfect square of the residues.
-    if (smoothNumberKeys.empty()) {
-        throw std::runtime_error("No smooth numbers found. Sieve more, or increase smoothness bound to reduce selectiveness. (The sieving bound multiplier is equivalent to that many times the square root of the number to factor, for calculated numerical range above an offset of the square root of the number to factor.)");
+// Combine every Krylov sequence part into dependencies, and finish with the congruence of squares.
+std::string block_wiedemann_solve(std::string matrixFile, size_t partCount) {
+  size_t seed;
+  const std::unique_ptr<Factorizer> worker = readRelationMatrix(matrixFile, seed);
+
+  std::vector<std::vector<BlockWord>> parts;
+  for (size_t partId = 0U; partId < partCount; ++partId) {
+    const std::string path = krylovPartFile(matrixFile, partId);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+      throw std::runtime_error("Could not open Krylov sequence part file for reading: " + path);
+    }
+    if ((readString(in) != KrylovPartMagic) || (readWord(in) != seed) || (readWord(in) != partId) || (readWord(in) != partCount)) {
+      throw std::runtime_error("Krylov sequence part file does not belong to this relation matrix and part count: " + path);
     }
+    std::vector<BlockWord> sequence(readWord(in));
+    if (!in.read(reinterpret_cast<char *>(sequence.data()), sequence.size() * sizeof(BlockWord))) {
+      throw std::runtime_error("Unexpected end of FindAFactor binary file!");
+    }
+    parts.push_back(sequence);
+  }
 
-    std::cout << std::endl;
-    std::cout << "Performing Gaussian elimination..." << std::endl;
+  const FilteredRelations relations = worker->filterRelations();
 
-    const std::vector<std::vector<size_t>> solutions = gaussianElimination();
-    for (const std::vector<size_t>& solution : solutions) {
-      const BigInteger factor = solveCongruence(solution);
-      if ((factor != 1U) && (factor != toFactor)) {
-        return factor;
-      }
-    }
+  std::cout << "Performing Block Wiedemann..." << std::endl;
 
-    // Depending on row count, a successful result should be nearly guaranteed,
-    // but we default to no solution.
-    throw std::runtime_error("No solution produced a congruence of squares. (We found " + std::to_string(solutions.size()) + " solutions, and even 1 should often be enough.)");
+  return boost::lexical_cast<std::string>(worker->solveCongruences(relations.expand(worker->blockWiedemann(relations, seed, parts))));
+}
+
+// Merge relation matrix files that independent nodes (or runs) dumped for the same number and factor base,
+// dropping duplicate relations, and spot-checking a random sample of each file's relations against that number.
+// The union goes to the usual linear algebra, unless "mergedFile" is set, in which case the union is written there
+// for Block Wiedemann, and "0" is returned instead.
+std::string merge_relations(std::vector<std::string> matrixFiles, std::string mergedFile) {
+  if (matrixFiles.empty()) {
+    throw std::runtime_error("No relation matrix files to merge!");
   }
+  const size_t sampleSize = 32U;
+  std::mt19937_64 rng(std::random_device{}());
+  std::unique_ptr<Factorizer> merged;
+  std::set<std::pair<std::string, uint64_t>> seen;
+  size_t duplicates = 0U;
+  for (const std::string &path : matrixFiles) {
+    size_t seed;
+    std::unique_ptr<Factorizer> worker = readRelationMatrix(path, seed);
+    std::vector<BigInteger> keys;
+    std::vector<boost::dynamic_bitset<size_t>> values;
+    keys.swap(worker->smoothNumberKeys);
+    values.swap(worker->smoothNumberValues);
+    if (!merged) {
+      merged = std::move(worker);
+    } else if ((worker->toFactor != merged->toFactor) || (worker->smoothPrimes != merged->smoothPrimes)) {
+      throw std::runtime_error("Relation matrix file is for a different number or factor base: " + path);
+    }
 
-  // Compute the prime factorization modulo 2
-  boost::dynamic_bitset<size_t> factorizationParityVector(BigInteger num) {
-    boost::dynamic_bitset<size_t> vec(smoothPrimes.size(), 0U);
-    std::vector<size_t> spids(smoothPrimes.size());
-    std::iota(spids.begin(), spids.end(), 0);
-    while (true) {
-      // Proceed in steps of the GCD with the smooth prime wheel radius.
-      BigInteger factor = gcd(num, smoothWheelRadius);
-      if (factor == 1U) {
-        break;
+    for (size_t s = 0U; (s < sampleSize) && (s < keys.size()); ++s) {
+      const size_t row = (keys.size() > sampleSize) ? (size_t)(rng() % keys.size()) : s;
+      const BigInteger &x = keys[row];
+      if (merged->factorizationParityVector((x * x) - merged->toFactor) != values[row]) {
+        throw std::runtime_error("Relation matrix file failed verification (relation " + std::to_string(row) + " is wrong): " + path);
       }
-      num /= factor;
-      // Remove smooth primes from factor.
-      // (The GCD is necessarily smooth.)
-      for (size_t pi = spids.size() - 1U; ; --pi) {
-        const size_t& pid = spids[pi];
-        const size_t& p = smoothPrimes[pid];
-        if (factor % p) {
-          // Once a preamble factor is found not to be present,
-          // there's no longer use trying for it on the next iteration.
-          spids.erase(spids.begin() + pi);
-          continue;
-        }
-        factor /= p;
-        vec.flip(pid);
-        if (factor == 1U) {
-          // The step is fully factored.
-          // (This case is always reached.)
-          spids.erase(spids.begin(), spids.begin() + pi);
-          break;
-        }
+    }
+
+    for (size_t row = 0U; row < keys.size(); ++row) {
+      // FNV-1a over the odd-exponent prime indices
+      uint64_t parityHash = 14695981039346656037ULL;
+      const boost::dynamic_bitset<size_t> &rfv = values[row];
+      for (size_t pid = rfv.find_first(); pid != boost::dynamic_bitset<size_t>::npos; pid = rfv.find_next(pid)) {
+        parityHash = (parityHash ^ pid) * 1099511628211ULL;
       }
-      if (num == 1U) {
-        // The number is fully factored and smooth.
-        return vec;
+      if (!seen.insert(std::make_pair(boost::lexical_cast<std::string>(keys[row]), parityHash)).second) {
+        ++duplicates;
+        continue;
       }
+      merged->smoothNumberKeys.push_back(keys[row]);
+      merged->smoothNumberValues.push_back(rfv);
     }
-    if (num != 1U) {
-      // The number was not fully factored, because it is not smooth.
-      // We reject it as a sieving candidate.
-      return boost::dynamic_bitset<size_t>();
-    }
-
-    // This number is smooth, and we return its factorization parity.
-    return vec;
   }
-};
-
-// Pollard's Rho factorization using Brent's improvement.
-// By (Anthropic) Claude
-//
-// Expected runtime O(n^(1/4)) — faster than trial division for
-// mid-range semiprimes, slower than Quadratic Sieve for large ones.
-// Fills the gap between wheel/gear trial division and QS.
-//
-// Brent's variant saves periodic "tortoise" checkpoints and batches
-// GCD computations (every `batchSize` steps), reducing GCD overhead
-// significantly vs. Floyd's cycle detection.
-//
-// Returns a non-trivial factor of n, or 1 if this attempt failed
-// (caller should retry with a different c).
-BigInteger pollardRhoBrent(const BigInteger& n, const BigInteger& c)
-{
-    if (n == 1U) return 1U;
+  // Every merged relation is kept through filtering.
+  merged->rowLimit = merged->smoothNumberKeys.size();
 
-    // Degenerate polynomial constants — skip.
-    if (c == 0U || c == n - 2U) return 1U;
+  std::cout << "Merged " << merged->smoothNumberKeys.size() << " relations from " << matrixFiles.size() << " files (" << duplicates << " duplicates dropped)." << std::endl;
 
-    BigInteger y = 2U;      // tortoise checkpoint
-    BigInteger r = 1U;      // Brent's power-of-2 cycle length
-    BigInteger q = 1U;      // accumulated product for batched GCD
-    BigInteger x, ys, factor;
+  if (!mergedFile.empty()) {
+    merged->writeRelationMatrix(mergedFile, std::random_device{}());
+    std::cout << "Relation matrix written to " << mergedFile << std::endl;
+    return std::to_string(0);
+  }
 
-    const size_t batchSize = 128U;  // batch GCD every this many steps
+  return boost::lexical_cast<std::string>(merged->solveForFactor());
+}
 
-    do {
-        x = y;
-        // Advance tortoise to start of next Brent segment
-        for (BigInteger i = 0U; i < r; ++i) {
-            y = (y * y + c) % n;
-        }
+// Relations are exchanged as text in the style of CADO-NFS relation files: one relation per line, as "x:p1,p2,...",
+// with x in decimal, and every prime factor of x^2 - N (repeated for its multiplicity) in hexadecimal.
+// Lines that are blank or start with '#' are comments.
+void export_relations(std::string matrixFile, std::string relationFile) {
+  size_t seed;
+  const std::unique_ptr<Factorizer> worker = readRelationMatrix(matrixFile, seed);
+  std::ofstream out(relationFile, std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("Could not open relation file for writing: " + relationFile);
+  }
+  out << "# FindAFactor relations for N = " << worker->toFactor << std::endl;
+  std::vector<size_t> exponents(worker->smoothPrimes.size());
+  for (const BigInteger &x : worker->smoothNumberKeys) {
+    std::fill(exponents.begin(), exponents.end(), 0U);
+    worker->factorizationExponents((x * x) - worker->toFactor, exponents);
+    out << x << ":";
+    bool isFirst = true;
+    for (size_t pid = 0U; pid < exponents.size(); ++pid) {
+      for (size_t e = 0U; e < exponents[pid]; ++e) {
+        out << (isFirst ? "" : ",") << std::hex << worker->smoothPrimes[pid] << std::dec;
+        isFirst = false;
+      }
+    }
+    out << "\n";
+  }
+  if (!out) {
+    throw std::runtime_error("Failed writing relation file: " + relationFile);
+  }
+}
 
-        BigInteger k = 0U;
-        factor = 1U;
+// Read externally generated relations for "toFactorStr" into a relation matrix file (see export_relations()).
+// Every relation's primes must multiply to x^2 - N. The factor base is every prime that appears.
+void import_relations(std::string toFactorStr, std::string relationFile, std::string matrixFile) {
+  const BigInteger toFactor(toFactorStr);
+  std::ifstream in(relationFile);
+  if (!in) {
+    throw std::runtime_error("Could not open relation file for reading: " + relationFile);
+  }
+  std::vector<BigInteger> keys;
+  std::vector<std::vector<size_t>> factors;
+  std::set<BigInteger> seen;
+  std::string line;
+  for (size_t lineNumber = 1U; std::getline(in, line); ++lineNumber) {
+    if (line.empty() || (line[0U] == '#')) {
+      continue;
+    }
+    const size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+      throw std::runtime_error("Relation line " + std::to_string(lineNumber) + " has no ':' separator: " + relationFile);
+    }
+    const BigInteger x(line.substr(0U, colon));
+    std::vector<size_t> primes;
+    BigInteger product = 1U;
+    std::istringstream primeList(line.substr(colon + 1U));
+    for (std::string hex; std::getline(primeList, hex, ',');) {
+      if (hex.empty()) {
+        continue;
+      }
+      const size_t p = (size_t)std::stoull(hex, nullptr, 16);
+      primes.push_back(p);
+      product *= p;
+    }
+    if (((x * x) <= toFactor) || (product != ((x * x) - toFactor))) {
+      throw std::runtime_error("Relation line " + std::to_string(lineNumber) + " does not factor x^2 - N: " + relationFile);
+    }
+    if (!seen.insert(x).second) {
+      continue;
+    }
+    keys.push_back(x);
+    factors.push_back(primes);
+  }
 
-        while (k < r && factor == 1U) {
-            ys = y;
-            const BigInteger steps = std::min(batchSize, (size_t)(r - k));
-            for (BigInteger i = 0U; i < steps; ++i) {
-                y = (y * y + c) % n;
-                const BigInteger diff = (y > x) ? (y - x) : (x - y);
-                q = (q * diff) % n;
-            }
-            factor = gcd(n, q);
-            k += steps;
-        }
+  std::set<size_t> primeSet;
+  for (const std::vector<size_t> &primes : factors) {
+    primeSet.insert(primes.begin(), primes.end());
+  }
+  const std::vector<size_t> smoothPrimes(primeSet.begin(), primeSet.end());
+  Factorizer worker(toFactor, sqrt(toFactor), 0U, 0U, 1U, 0U, 1U, keys.size(), 0U, smoothPrimes, forward(WHEEL1), backward(WHEEL1), 0U);
+  for (size_t row = 0U; row < keys.size(); ++row) {
+    boost::dynamic_bitset<size_t> rfv(smoothPrimes.size(), 0U);
+    for (const size_t &p : factors[row]) {
+      rfv.flip(std::lower_bound(smoothPrimes.begin(), smoothPrimes.end(), p) - smoothPrimes.begin());
+    }
+    worker.smoothNumberKeys.push_back(keys[row]);
+    worker.smoothNumberValues.push_back(rfv);
+  }
+  worker.writeRelationMatrix(matrixFile, std::random_device{}());
 
-        r <<= 1U;
+  std::cout << "Imported " << keys.size() << " relations over " << smoothPrimes.size() << " primes." << std::endl;
+}
 
-    } while (factor == 1U);
+// Export the (filtered) relation matrix for an external GF(2) solver, with one row per filtered relation
+// and one column per surviving prime. Formats are:
+//   "cado":     CADO-NFS text matrix, a "rows columns" line, and then "weight column..." per row
+//   "cado-bin": CADO-NFS binary matrix, as little-endian 32-bit words, with the same layout per row
+//   "msieve":   msieve's .mat layout, with 32-bit row count, dense row count (0), and column count,
+//               and then "weight row..." per column, since msieve's columns are relations
+// Filtering is deterministic, so solve_dependencies() can map the solver's output back to relations.
+void export_matrix(std::string matrixFile, std::string outFile, std::string format) {
+  size_t seed;
+  const std::unique_ptr<Factorizer> worker = readRelationMatrix(matrixFile, seed);
+  const FilteredRelations relations = worker->filterRelations();
+  const bool isText = (format == "cado");
+  if (!isText && (format != "cado-bin") && (format != "msieve")) {
+    throw std::runtime_error("Unknown matrix format (use \"cado\", \"cado-bin\", or \"msieve\"): " + format);
+  }
+  std::ofstream out(outFile, isText ? std::ios::trunc : (std::ios::binary | std::ios::trunc));
+  if (!out) {
+    throw std::runtime_error("Could not open matrix file for writing: " + outFile);
+  }
+  const auto writeU32 = [&out](size_t w) {
+    if (w > 0xFFFFFFFFULL) {
+      throw std::runtime_error("Matrix is too large for 32-bit matrix file format!");
+    }
+    const unsigned char bytes[4U] = { (unsigned char)w, (unsigned char)(w >> 8U), (unsigned char)(w >> 16U), (unsigned char)(w >> 24U) };
+    out.write(reinterpret_cast<const char *>(bytes), 4U);
+  };
 
-    // If we got n itself, fall back to step-by-step from last checkpoint
-    if (factor == n) {
-        factor = 1U;
-        y = ys;
-        while (factor == 1U) {
-            y = (y * y + c) % n;
-            const BigInteger diff = (y > x) ? (y - x) : (x - y);
-            factor = gcd(n, diff);
-        }
+  if (isText) {
+    out << relations.rows.size() << " " << relations.columnCount << "\n";
+  } else if (format == "msieve") {
+    writeU32(relations.columnCount);
+    writeU32(0U);
+    writeU32(relations.rows.size());
+  }
+  for (const boost::dynamic_bitset<size_t> &row : relations.rows) {
+    if (isText) {
+      out << row.count();
+    } else {
+      writeU32(row.count());
     }
+    for (size_t col = row.find_first(); col != boost::dynamic_bitset<size_t>::npos; col = row.find_next(col)) {
+      if (isText) {
+        out << " " << col;
+      } else {
+        writeU32(col);
+      }
+    }
+    if (isText) {
+      out << "\n";
+    }
+  }
+  if (!out) {
+    throw std::runtime_error("Failed writing matrix file: " + outFile);
+  }
 
-    return (factor == n) ? 1U : factor;
+  std::cout << "Exported " << relations.rows.size() << " x " << relations.columnCount << " filtered relation matrix." << std::endl;
 }
 
-// Driver: try multiple (c) values across available CPU threads.
-// Returns a non-trivial factor, or 1 if all attempts failed.
-BigInteger pollardRho(const BigInteger& n, const BigInteger& sqrtN)
-{
-    if (n <= 3U) return 1U;
+// Finish with dependencies that an external solver found for the matrix from export_matrix(),
+// given as one little-endian 64-bit word per filtered relation, where bit k marks membership in dependency k
+// (as in msieve's .dep files).
+std::string solve_dependencies(std::string matrixFile, std::string dependencyFile) {
+  size_t seed;
+  const std::unique_ptr<Factorizer> worker = readRelationMatrix(matrixFile, seed);
+  const FilteredRelations relations = worker->filterRelations();
+  std::ifstream in(dependencyFile, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Could not open dependency file for reading: " + dependencyFile);
+  }
+  std::vector<BlockWord> words(relations.rows.size());
+  for (BlockWord &w : words) {
+    unsigned char bytes[8U];
+    if (!in.read(reinterpret_cast<char *>(bytes), 8U)) {
+      throw std::runtime_error("Dependency file is shorter than the filtered relation matrix: " + dependencyFile);
+    }
+    w = 0U;
+    for (size_t b = 8U; b-- > 0U;) {
+      w = (w << 8U) | bytes[b];
+    }
+  }
 
-    // Quick perfect-square check (already done in caller, but be safe)
-    if (sqrtN * sqrtN == n) return sqrtN;
+  std::vector<std::vector<size_t>> solutions;
+  for (size_t k = 0U; k < 64U; ++k) {
+    std::vector<size_t> selectedRows;
+    for (size_t row = 0U; row < words.size(); ++row) {
+      if ((words[row] >> k) & 1U) {
+        selectedRows.push_back(row);
+      }
+    }
+    if (!selectedRows.empty()) {
+      solutions.push_back(selectedRows);
+    }
+  }
 
-    std::atomic<bool> found(false);
-    BigInteger result = 1U;
-    std::mutex resultMutex;
+  return boost::lexical_cast<std::string>(worker->solveCongruences(relations.expand(solutions)));
+}
 
-    // Each thread tries a different c value.  c = 1 is the classic choice;
-    // we fan out from there.  Values 0 and n-2 are degenerate — skip them.
-    const size_t maxAttempts = CpuCount * 8U;
+// Split every number in a batch (as decimal strings) with Pollard's Rho, returning a factor (or 1) for each. See pollardRhoBatch().
+std::vector<std::string> pollard_rho_batch(std::vector<std::string> numbers, size_t maxIterations) {
+  std::vector<BigInteger> values;
+  values.reserve(numbers.size());
+  for (const std::string &n : numbers) {
+    values.emplace_back(n);
+  }
+  const std::vector<BigInteger> factors = pollardRhoBatch(values, maxIterations);
+  std::vector<std::string> result;
+  result.reserve(factors.size());
+  for (const BigInteger &f : factors) {
+    result.push_back(boost::lexical_cast<std::string>(f));
+  }
 
-    std::vector<std::future<BigInteger>> futures;
-    futures.reserve(maxAttempts);
+  return result;
+}
 
-    for (size_t attempt = 0U; attempt < maxAttempts; ++attempt) {
-        const BigInteger c = (BigInteger)(attempt + 1U);
-        if (c == n - 2U) continue;
+// Fully factor every element of a (contiguous) uint64 array, in place, into preallocated (count x 15) arrays
+// of distinct primes (uint64) and their exponents (uint8). See factorU64().
+void find_factors_u64(pybind11::array_t<uint64_t, pybind11::array::c_style> numbers, pybind11::array_t<uint64_t, pybind11::array::c_style> primes,
+                      pybind11::array_t<uint8_t, pybind11::array::c_style> exponents) {
+  const size_t count = numbers.size();
+  if ((primes.size() != (count * U64FactorSlots)) || (exponents.size() != (count * U64FactorSlots))) {
+    throw std::runtime_error("Prime and exponent arrays must have " + std::to_string(U64FactorSlots) + " entries per number!");
+  }
+  const uint64_t *in = numbers.data();
+  uint64_t *primesOut = primes.mutable_data();
+  uint8_t *exponentsOut = exponents.mutable_data();
+  // (No Python objects are touched until this returns.)
+  pybind11::gil_scoped_release release;
+  factorU64Batch(in, count, primesOut, exponentsOut);
+}
 
-        futures.push_back(std::async(std::launch::async,
-            [&n, &found, c]() -> BigInteger {
-                if (found.load(std::memory_order_relaxed)) return 1U;
-                const BigInteger f = pollardRhoBrent(n, c);
-                if (f > 1U && f < n) {
-                    found.store(true, std::memory_order_relaxed);
-                    return f;
-                }
-                return 1U;
-            }));
+// Factor every integer in [low, high], a wave at a time, into preallocated (capacity x 15) prime and exponent arrays,
+// (as in find_factors_u64()), calling emit(first, count) after each wave, while the arrays hold its rows.
+// The thread pool takes segments of "segmentSize" numbers from each wave. See factorRangeWave().
+void factor_range(uint64_t low, uint64_t high, size_t segmentSize, pybind11::array_t<uint64_t, pybind11::array::c_style> primes,
+                  pybind11::array_t<uint8_t, pybind11::array::c_style> exponents, std::function<void(uint64_t, size_t)> emit) {
+  const size_t capacity = primes.size() / U64FactorSlots;
+  if (!capacity || (exponents.size() != (capacity * U64FactorSlots))) {
+    throw std::runtime_error("Prime and exponent arrays must have the same, nonzero, multiple of " + std::to_string(U64FactorSlots) + " entries!");
+  }
+  if (low > high) {
+    return;
+  }
+  if (!segmentSize) {
+    segmentSize = 1U << 15U;
+  }
+  // Base primes, up to the square root of high, are shared by every wave.
+  // (Every segment runs through all of them, so ranges far above 2^50 cost more to set up and sieve.)
+  const std::vector<size_t> basePrimes = SieveOfEratosthenes((size_t)isqrt64(high));
+  uint64_t *primesOut = primes.mutable_data();
+  uint8_t *exponentsOut = exponents.mutable_data();
+  for (uint64_t first = low;; first += capacity) {
+    const bool isLast = (high - first) < capacity;
+    const size_t count = isLast ? (size_t)(high - first + 1U) : capacity;
+    {
+      // (No Python objects are touched while the wave runs.)
+      pybind11::gil_scoped_release release;
+      factorRangeWave(first, count, segmentSize, basePrimes, primesOut, exponentsOut);
     }
-
-    for (auto& fut : futures) {
-        const BigInteger f = fut.get();
-        if (f > 1U && f < n) {
-            std::lock_guard<std::mutex> lk(resultMutex);
-            if (result == 1U) result = f;
-        }
+    emit(first, count);
+    if (isLast) {
+      break;
     }
-
-    return result;
+  }
 }
 
 std::string find_a_factor(std::string toFactorStr, size_t method, size_t nodeCount, size_t nodeId, size_t gearFactorizationLevel, size_t wheelFactorizationLevel,
-                          double sievingBoundMultiplier, double smoothnessBoundMultiplier, size_t gaussianEliminationRowOffset, bool checkSmallFactors, std::vector<size_t> wheelPrimesExcluded) {
+                          double sievingBoundMultiplier, double smoothnessBoundMultiplier, size_t gaussianEliminationRowOffset, bool checkSmallFactors, std::vector<size_t> wheelPrimesExcluded,
+                          std::string matrixFile, size_t matrixMemoryLimitMb, bool isIncrementalElimination, size_t retryRoundLimit,
+                          std::string relationLogFile, size_t rhoFactorBits, size_t pollardPm1B1, size_t pollardPm1B2, bool isPollardPm1PreCheck,
+                          size_t williamsPp1B1, size_t williamsPp1B2, bool isWilliamsPp1PreCheck,
+                          size_t ecmB1, size_t ecmB2, size_t ecmCurveCount, size_t ecmFactorDigits,
+                          size_t gnfsDegree, size_t gnfsFactorBaseBound, size_t gnfsSieveRadius) {
   // Validation section
-  if (method > 2U) {
+  if (method > 8U) {
     std::cout << "Mode number " << method << " not implemented. Defaulting to FACTOR_FINDER." << std::endl;
     method = 1U;
   }
   const bool isPollardRho = (method == 2U);
+  const bool isPollardPm1 = (method == 3U);
+  const bool isWilliamsPp1 = (method == 4U);
+  const bool isEcm = (method == 5U);
+  const bool isSqufof = (method == 6U);
   const bool isFactorFinder = (method == 1U);
+  const bool isCfrac = (method == 7U);
+  const bool isGnfs = (method == 8U);
+  // Both need a factor base, relations, and linear algebra.
+  const bool isCongruenceOfSquares = isFactorFinder || isCfrac;
+  if ((isCfrac || isGnfs) && !matrixFile.empty()) {
+    std::cout << "Warning: " << (isCfrac ? "CFRAC" : "GNFS") << " method solves its relation matrix in-process. (matrix_file will be ignored.)" << std::endl;
+    matrixFile.clear();
+  }
   if (!wheelFactorizationLevel) {
     wheelFactorizationLevel = 1U;
   } else if (!method && (wheelFactorizationLevel > 17U)) {
@@ -888,12 +5103,24 @@ std::string find_a_factor(std::string toFactorStr, size_t method, size_t nodeCou
   // Convert number to factor from string.
   const BigInteger toFactor(toFactorStr);
 
+  // Tiny numbers are factored inline, on this thread, before any setup (prime sieve, wheels, or thread pool).
+  if (toFactor < HartLehmanLimit) {
+    return std::to_string(hartLehman((uint64_t)toFactor));
+  }
+
   // The largest possible discrete factor of "toFactor" is its square root (as with any integer).
   const BigInteger sqrtN = sqrt(toFactor);
   if (sqrtN * sqrtN == toFactor) {
     return boost::lexical_cast<std::string>(sqrtN);
   }
 
+  // Fermat's method, for a small fixed budget, catches factors that are close to the square root,
+  // (as from poorly generated RSA keys) before any method sends them to slower algorithms.
+  const BigInteger fermatResult = fermat(toFactor, sqrtN, FermatBudget);
+  if (fermatResult != 1U) {
+    return boost::lexical_cast<std::string>(fermatResult);
+  }
+
   // This level default (scaling) was suggested by Elara (OpenAI GPT).
   const double N = toFactor.convert_to<double>();
   const double logN = log(N);
@@ -933,27 +5160,83 @@ std::string find_a_factor(std::string toFactorStr, size_t method, size_t nodeCou
       return boost::lexical_cast<std::string>(result);
     }
   }
+  // Pollard's p - 1: method 3, or (optionally) as a fast pre-check before Pollard's Rho and Quadratic Sieve.
+  // This finds a factor p in milliseconds, whatever its size, if p - 1 is smooth.
+  if (isPollardPm1 || (isFactorFinder && isPollardPm1PreCheck)) {
+    const BigInteger pm1Result = pollardPm1(toFactor, pollardPm1B1, pollardPm1B2 ? pollardPm1B2 : (100U * pollardPm1B1), nodeId);
+    if (pm1Result > 1U && pm1Result < toFactor) {
+      return boost::lexical_cast<std::string>(pm1Result);
+    }
+    if (isPollardPm1) {
+      return std::to_string(1);
+    }
+  }
+
+  // Williams' p + 1: method 4, or (optionally) as a pre-check, for factors p with smooth p + 1.
+  if (isWilliamsPp1 || (isFactorFinder && isWilliamsPp1PreCheck)) {
+    const BigInteger pp1Result = williamsPp1(toFactor, williamsPp1B1, williamsPp1B2 ? williamsPp1B2 : (100U * williamsPp1B1), nodeCount, nodeId);
+    if (pp1Result > 1U && pp1Result < toFactor) {
+      return boost::lexical_cast<std::string>(pp1Result);
+    }
+    if (isWilliamsPp1) {
+      return std::to_string(1);
+    }
+  }
+
+  // Lenstra's elliptic curve method: method 5, for factors up to about 40 digits, whatever the size of the number to factor.
+  if (isEcm) {
+    size_t suggestedB1, suggestedCurveCount;
+    ecmParameters(ecmFactorDigits, suggestedB1, suggestedCurveCount);
+    if (!ecmB1) {
+      ecmB1 = suggestedB1;
+    }
+    if (!ecmCurveCount) {
+      ecmCurveCount = suggestedCurveCount;
+    }
+    const BigInteger ecmResult = ecm(toFactor, ecmB1, ecmB2 ? ecmB2 : (100U * ecmB1), ecmCurveCount, nodeCount, nodeId);
+
+    return boost::lexical_cast<std::string>((ecmResult < toFactor) ? ecmResult : (BigInteger)1U);
+  }
+
+  // SQUFOF: method 6, and also the first choice for FACTOR_FINDER and POLLARD_RHO below 2^62,
+  // where it needs no multiprecision at all.
+  const bool isSqufofRange = (toFactor < (((BigInteger)1U) << 62U));
+  if (isSqufof && !isSqufofRange) {
+    std::cout << "Warning: SQUFOF method is only for numbers below 2^62. (Defaulting to POLLARD_RHO.)" << std::endl;
+  } else if (isSqufofRange && (isSqufof || isFactorFinder || isPollardRho)) {
+    const uint64_t squfofResult = squfof((uint64_t)toFactor);
+    if ((squfofResult > 1U) || isSqufof) {
+      return std::to_string(squfofResult);
+    }
+  }
+
   // Pollard's Rho: method 2, or as a fast pre-check before Quadratic Sieve.
   // Effective for mid-range semiprimes where trial division is too slow
   // but Quadratic Sieve setup cost isn't yet justified.
-  if (isPollardRho || isFactorFinder) {
-    const BigInteger rhoResult = pollardRho(toFactor, sqrtN);
+  // (As a pre-check, it only gets the budget to find a factor of up to rhoFactorBits bits.)
+  if (isPollardRho || isSqufof || (isFactorFinder && rhoFactorBits)) {
+    const BigInteger rhoResult = pollardRho(toFactor, sqrtN, (isPollardRho || isSqufof) ? 0U : pollardRhoBudget(toFactor, rhoFactorBits), nodeCount, nodeId);
     if (rhoResult > 1U && rhoResult < toFactor) {
       return boost::lexical_cast<std::string>(rhoResult);
     }
     // If Pollard's Rho failed and we're in method 2, report failure.
-    if (isPollardRho) {
+    if (isPollardRho || isSqufof) {
       return std::to_string(1);
     }
     // Otherwise fall through to Quadratic Sieve.
   }
 
+  // The general number field sieve has its own factor bases (on both sides of its polynomial) and sieve.
+  if (isGnfs) {
+    return boost::lexical_cast<std::string>(gnfs(toFactor, gnfsDegree, gnfsFactorBaseBound, gnfsSieveRadius, gaussianEliminationRowOffset, nodeCount, nodeId));
+  }
+
   // Set up wheel factorization (or "gear" factorization)
   std::vector<size_t> gearFactorizationPrimes(primes.begin(), itg);
   std::vector<size_t> wheelFactorizationPrimes(primes.begin(), itw);
   // Primes are only present in range above wheel factorization level
   std::vector<size_t> smoothPrimes;
-  if (isFactorFinder) {
+  if (isCongruenceOfSquares) {
     smoothPrimes = selectFactorBase(toFactor, primes);
     if (smoothPrimes.empty()) {
       throw std::runtime_error("No smooth primes found under bound. (The formula smoothness bound calculates to " + std::to_string(primeCeiling) + ".) Increase the smoothness bound multiplier, unless this is in range of check_small_factors=True.");
@@ -1022,21 +5305,57 @@ std::string find_a_factor(std::string toFactorStr, size_t method, size_t nodeCou
                                       + batchItemCount - 1U) / batchItemCount) + nodeCount - 1U) / nodeCount;
 
   // This manages the work of all threads.
+  // (CFRAC hands out expansion streams of sqrt(m^2 N) as its "batches.")
   Factorizer worker(toFactor, sqrtN, qsBackwardLowBound,
-                    isFactorFinder ? qsNodeRange : ppNodeRange,
+                    isFactorFinder ? qsNodeRange : (isCfrac ? (((BigInteger)1U) << 32U) : ppNodeRange),
                     nodeCount, nodeId,
                     batchItemCount,
                     rowLimit,
                     isFactorFinder ? 0U : ppStartingBatch,
                     smoothPrimes,
                     isFactorFinder ? ((wheel.size() > 1U) ? smoothForwardFn : forward(WHEEL1)) : ppForwardFn,
-                    isFactorFinder ? ((wheel.size() > 1U) ? smoothBackwardFn : backward(WHEEL1)) : ppBackwardFn);
+                    isFactorFinder ? ((wheel.size() > 1U) ? smoothBackwardFn : backward(WHEEL1)) : ppBackwardFn,
+                    matrixMemoryLimitMb << 20U);
   // Square of count of smooth primes, for FACTOR_FINDER batch multiplier base unit, was suggested by Lyra (OpenAI GPT)
+  worker.isCfrac = isCfrac;
+
+  // Sieving is checkpointed to the relation log, and it resumes from the log, if that's from an earlier run of the same job.
+  std::unique_ptr<RelationLog> relationLog;
+  if (isFactorFinder && !relationLogFile.empty()) {
+    std::ostringstream fingerprint;
+    fingerprint << toFactor << " " << nodeCount << " " << nodeId << " " << batchItemCount << " " << wheel.size() << " " << qsBackwardLowBound << " " << qsNodeRange;
+    for (const size_t &p : smoothPrimes) {
+      fingerprint << " " << p;
+    }
+    relationLog.reset(new RelationLog(relationLogFile, fingerprint.str()));
+    for (size_t i = 0U; i < relationLog->restoredKeys.size(); ++i) {
+      boost::dynamic_bitset<size_t> rfv(smoothPrimes.size(), 0U);
+      for (const size_t &pid : relationLog->restoredPrimeIds[i]) {
+        if (pid >= smoothPrimes.size()) {
+          throw std::runtime_error("Relation log has a prime index out of range: " + relationLogFile);
+        }
+        rfv.set(pid);
+      }
+      worker.smoothNumberKeys.push_back(relationLog->restoredKeys[i]);
+      worker.smoothNumberValues.push_back(rfv);
+    }
+    worker.batchNumber = relationLog->restoredBatchNumber();
+    if (worker.smoothNumberKeys.size() > rowLimit) {
+      worker.isIncomplete = false;
+    }
+    if (!relationLog->restoredKeys.empty() || (worker.batchNumber > 0U)) {
+      std::cout << "Resumed " << worker.smoothNumberKeys.size() << " relations from " << relationLogFile << ", sieving from batch " << worker.batchNumber << "." << std::endl;
+    }
+    relationLog->restoredKeys.clear();
+    relationLog->restoredPrimeIds.clear();
+    worker.relationLog = relationLog.get();
+  }
 
-  std::vector<std::future<BigInteger>> futures;
-  futures.reserve(CpuCount);
+  const auto workerFn = [&inc_seqs, &worker, &isFactorFinder, &isCfrac] {
+    if (isCfrac) {
+      return worker.cfracStreams();
+    }
 
-  const auto workerFn = [&inc_seqs, &worker, &isFactorFinder] {
     // inc_seq needs to be independent per thread.
     std::vector<boost::dynamic_bitset<size_t>> inc_seqs_clone;
     inc_seqs_clone.reserve(inc_seqs.size());
@@ -1048,25 +5367,67 @@ std::string find_a_factor(std::string toFactorStr, size_t method, size_t nodeCou
     return isFactorFinder ? worker.sievePolynomials(&inc_seqs_clone) : worker.bruteForce(&inc_seqs_clone);
   };
 
-  if (isFactorFinder) {
-    std::cout << "Smooth numbers: ";
-  }
+  // If no dependency gives a factor, the relations are kept, and sieving resumes for another round.
+  for (size_t round = 0U; ; ++round) {
+    if (isCongruenceOfSquares) {
+      std::cout << "Smooth numbers: ";
+    }
 
-  for (unsigned cpu = 0U; cpu < CpuCount; ++cpu) {
-    futures.push_back(std::async(std::launch::async, workerFn));
-  }
+    std::vector<std::future<BigInteger>> futures;
+    futures.reserve(CpuCount);
+    for (unsigned cpu = 0U; cpu < CpuCount; ++cpu) {
+      futures.push_back(std::async(std::launch::async, workerFn));
+    }
 
-  for (unsigned cpu = 0U; cpu < futures.size(); ++cpu) {
-    const BigInteger r = futures[cpu].get();
-    if ((r > 1U) && (r < toFactor)) {
-      return boost::lexical_cast<std::string>(r);
+    // Relations can be reduced in the background, as they arrive.
+    std::future<BigInteger> onlineFuture;
+    if (isCongruenceOfSquares && isIncrementalElimination) {
+      onlineFuture = std::async(std::launch::async, [&worker] { return worker.eliminateOnline(); });
+    }
+
+    BigInteger sieveResult = 1U;
+    for (unsigned cpu = 0U; cpu < futures.size(); ++cpu) {
+      const BigInteger r = futures[cpu].get();
+      if ((r > 1U) && (r < toFactor)) {
+        sieveResult = r;
+        break;
+      }
+    }
+
+    if (onlineFuture.valid()) {
+      worker.stopSieving();
+      const BigInteger r = onlineFuture.get();
+      if ((r > 1U) && (r < toFactor)) {
+        std::cout << std::endl << "Incremental elimination found a congruence of squares." << std::endl;
+        return boost::lexical_cast<std::string>(r);
+      }
+    }
+
+    if (sieveResult != 1U) {
+      return boost::lexical_cast<std::string>(sieveResult);
     }
-  }
 
-  // It's only convenient that a large part of the `FACTOR_FINDER` work
-  // happens in a second phase, after a first phase with identical signature.
-  if (isFactorFinder) {
-    return boost::lexical_cast<std::string>(worker.solveForFactor());
+    // It's only convenient that a large part of the `FACTOR_FINDER` work
+    // happens in a second phase, after a first phase with identical signature.
+    if (!isCongruenceOfSquares) {
+      break;
+    }
+    if (!matrixFile.empty()) {
+      // Linear algebra is left to Block Wiedemann parts that load this file.
+      // ("0" is never a factor, so it tells the caller as much.)
+      worker.writeRelationMatrix(matrixFile, std::random_device{}());
+      std::cout << std::endl << "Relation matrix written to " << matrixFile << std::endl;
+      return std::to_string(0);
+    }
+    try {
+      return boost::lexical_cast<std::string>(worker.solveForFactor());
+    } catch (const std::runtime_error &e) {
+      if ((round >= retryRoundLimit) || !worker.resumeSieving(std::max(gaussianEliminationRowOffset, (size_t)1U))) {
+        throw;
+      }
+      std::cout << e.what() << std::endl;
+      std::cout << "Keeping " << worker.smoothNumberKeys.size() << " relations, and sieving for more (retry " << (round + 1U) << " of " << retryRoundLimit << ")..." << std::endl;
+    }
   }
 
   // We would have already returned if we found a factor.
@@ -1081,5 +5442,21 @@ PYBIND11_MODULE(_find_a_factor, m) {
   // method: 0 = PRIME_PROVER (brute force trial division)
   //         1 = FACTOR_FINDER (Pollard's Rho pre-check + Quadratic Sieve)
   //         2 = POLLARD_RHO (Pollard's Rho only, O(n^1/4))
+  //         3 = POLLARD_PM1 (Pollard's p - 1 only, for factors p with smooth p - 1)
+  //         4 = WILLIAMS_PP1 (Williams' p + 1 only, for factors p with smooth p + 1)
+  //         5 = ECM (Lenstra's elliptic curve method, for factors of up to about 40 digits)
+  //         6 = SQUFOF (Shanks' square forms factorization, in 64-bit arithmetic, for numbers below 2^62)
+  //         7 = CFRAC (continued fraction factorization, with the Quadratic Sieve's linear algebra)
+  //         8 = GNFS (general number field sieve, with a base-m polynomial of odd degree)
   m.def("_find_a_factor", &find_a_factor, "Finds any nontrivial factor of input");
+  m.def("_block_wiedemann_part", &block_wiedemann_part, "Computes one part of the Block Wiedemann Krylov sequence for a relation matrix file");
+  m.def("_block_wiedemann_solve", &block_wiedemann_solve, "Combines Block Wiedemann Krylov sequence parts to find any nontrivial factor");
+  m.def("_merge_relations", &merge_relations, "Merges relation matrix files from independent runs, and solves the union for any nontrivial factor");
+  m.def("_export_relations", &export_relations, "Writes the relations in a relation matrix file as CADO-NFS style text relations");
+  m.def("_import_relations", &import_relations, "Reads CADO-NFS style text relations into a relation matrix file");
+  m.def("_export_matrix", &export_matrix, "Writes the filtered relation matrix in CADO-NFS or msieve matrix format");
+  m.def("_solve_dependencies", &solve_dependencies, "Finds any nontrivial factor from an external solver's dependency file");
+  m.def("_pollard_rho_batch", &pollard_rho_batch, "Splits every number in a batch with multi-lane Pollard's Rho");
+  m.def("_find_factors_u64", &find_factors_u64, "Fully factors every element of a uint64 array, into preallocated prime and exponent arrays");
+  m.def("_factor_range", &factor_range, "Fully factors every integer in a range by a segmented sieve, a wave of segments at a time");
 }
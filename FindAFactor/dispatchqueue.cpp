@@ -104,6 +104,7 @@ void DispatchQueue::dispatch_thread_handler(void)
 
         auto op = std::move(q_.front());
         q_.pop();
+        ++running_;
 
         // unlock now that we're done messing with the queue
         lock.unlock();
@@ -112,8 +113,11 @@ void DispatchQueue::dispatch_thread_handler(void)
         quit_ |= result;
 
         lock.lock();
+        --running_;
 
-        if (!q_.size()) {
+        // The queue is only finished once no other thread is still running an op,
+        // unless an op has already produced the result and every thread is quitting.
+        if (quit_ || (!q_.size() && !running_)) {
             isFinished_ = true;
             cvFinished_.notify_all();
         }
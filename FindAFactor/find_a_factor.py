@@ -1,3 +1,5 @@
+import multiprocessing
+import numpy
 import os
 import _find_a_factor
 from enum import IntEnum
@@ -7,6 +9,12 @@ class FactoringMethod(IntEnum):
     PRIME_PROVER = 0
     FACTOR_FINDER = 1
     POLLARD_RHO = 2
+    POLLARD_PM1 = 3
+    WILLIAMS_PP1 = 4
+    ECM = 5
+    SQUFOF = 6
+    CFRAC = 7
+    GNFS = 8
 
 
 def find_a_factor(n,
@@ -19,8 +27,29 @@ def find_a_factor(n,
                   smoothness_bound_multiplier=float(os.environ.get('FINDAFACTOR_SMOOTHNESS_BOUND_MULTIPLIER')) if os.environ.get('FINDAFACTOR_SMOOTHNESS_BOUND_MULTIPLIER') else 1.0,
                   gaussian_elimination_row_offset=int(os.environ.get('FINDAFACTOR_GAUSSIAN_ELIMINATION_ROW_OFFSET')) if os.environ.get('FINDAFACTOR_GAUSSIAN_ELIMINATION_ROW_OFFSET') else 1,
                   check_small_factors=True if os.environ.get('FINDAFACTOR_CHECK_SMALL_FACTORS') else False,
-                  wheel_primes_excluded=[int(i) for i in os.environ.get('FINDAFACTOR_WHEEL_PRIMES_EXCLUDED').split(",")] if os.environ.get('FINDAFACTOR_GAUSSIAN_ELIMINATION_ROW_OFFSET') else []):
-    return int(_find_a_factor._find_a_factor(str(n),
+                  wheel_primes_excluded=[int(i) for i in os.environ.get('FINDAFACTOR_WHEEL_PRIMES_EXCLUDED').split(",")] if os.environ.get('FINDAFACTOR_GAUSSIAN_ELIMINATION_ROW_OFFSET') else [],
+                  matrix_file=os.environ.get('FINDAFACTOR_MATRIX_FILE') if os.environ.get('FINDAFACTOR_MATRIX_FILE') else "",
+                  wiedemann_process_count=int(os.environ.get('FINDAFACTOR_WIEDEMANN_PROCESS_COUNT')) if os.environ.get('FINDAFACTOR_WIEDEMANN_PROCESS_COUNT') else 1,
+                  matrix_memory_limit_mb=int(os.environ.get('FINDAFACTOR_MATRIX_MEMORY_LIMIT_MB')) if os.environ.get('FINDAFACTOR_MATRIX_MEMORY_LIMIT_MB') else 0,
+                  incremental_elimination=True if os.environ.get('FINDAFACTOR_INCREMENTAL_ELIMINATION') else False,
+                  retry_round_limit=int(os.environ.get('FINDAFACTOR_RETRY_ROUND_LIMIT')) if os.environ.get('FINDAFACTOR_RETRY_ROUND_LIMIT') else 3,
+                  relation_log=os.environ.get('FINDAFACTOR_RELATION_LOG') if os.environ.get('FINDAFACTOR_RELATION_LOG') else "",
+                  rho_factor_bits=int(os.environ.get('FINDAFACTOR_RHO_FACTOR_BITS')) if os.environ.get('FINDAFACTOR_RHO_FACTOR_BITS') else 40,
+                  pollard_pm1_b1=int(os.environ.get('FINDAFACTOR_POLLARD_PM1_B1')) if os.environ.get('FINDAFACTOR_POLLARD_PM1_B1') else 100000,
+                  pollard_pm1_b2=int(os.environ.get('FINDAFACTOR_POLLARD_PM1_B2')) if os.environ.get('FINDAFACTOR_POLLARD_PM1_B2') else 0,
+                  pollard_pm1_pre_check=True if os.environ.get('FINDAFACTOR_POLLARD_PM1_PRE_CHECK') else False,
+                  williams_pp1_b1=int(os.environ.get('FINDAFACTOR_WILLIAMS_PP1_B1')) if os.environ.get('FINDAFACTOR_WILLIAMS_PP1_B1') else 50000,
+                  williams_pp1_b2=int(os.environ.get('FINDAFACTOR_WILLIAMS_PP1_B2')) if os.environ.get('FINDAFACTOR_WILLIAMS_PP1_B2') else 0,
+                  williams_pp1_pre_check=True if os.environ.get('FINDAFACTOR_WILLIAMS_PP1_PRE_CHECK') else False,
+                  ecm_b1=int(os.environ.get('FINDAFACTOR_ECM_B1')) if os.environ.get('FINDAFACTOR_ECM_B1') else 0,
+                  ecm_b2=int(os.environ.get('FINDAFACTOR_ECM_B2')) if os.environ.get('FINDAFACTOR_ECM_B2') else 0,
+                  ecm_curve_count=int(os.environ.get('FINDAFACTOR_ECM_CURVE_COUNT')) if os.environ.get('FINDAFACTOR_ECM_CURVE_COUNT') else 0,
+                  ecm_factor_digits=int(os.environ.get('FINDAFACTOR_ECM_FACTOR_DIGITS')) if os.environ.get('FINDAFACTOR_ECM_FACTOR_DIGITS') else 25,
+                  gnfs_degree=int(os.environ.get('FINDAFACTOR_GNFS_DEGREE')) if os.environ.get('FINDAFACTOR_GNFS_DEGREE') else 0,
+                  gnfs_factor_base_bound=int(os.environ.get('FINDAFACTOR_GNFS_FACTOR_BASE_BOUND')) if os.environ.get('FINDAFACTOR_GNFS_FACTOR_BASE_BOUND') else 0,
+                  gnfs_sieve_radius=int(os.environ.get('FINDAFACTOR_GNFS_SIEVE_RADIUS')) if os.environ.get('FINDAFACTOR_GNFS_SIEVE_RADIUS') else 0,
+                  sieve_only=True if os.environ.get('FINDAFACTOR_SIEVE_ONLY') else False):
+    result = int(_find_a_factor._find_a_factor(str(n),
                                              int(method),
                                              node_count, node_id,
                                              gear_factorization_level,
@@ -29,4 +58,104 @@ def find_a_factor(n,
                                              smoothness_bound_multiplier,
                                              gaussian_elimination_row_offset,
                                              check_small_factors,
-                                             wheel_primes_excluded))
+                                             wheel_primes_excluded,
+                                             matrix_file,
+                                             matrix_memory_limit_mb,
+                                             incremental_elimination,
+                                             retry_round_limit,
+                                             relation_log,
+                                             rho_factor_bits,
+                                             pollard_pm1_b1,
+                                             pollard_pm1_b2,
+                                             pollard_pm1_pre_check,
+                                             williams_pp1_b1,
+                                             williams_pp1_b2,
+                                             williams_pp1_pre_check,
+                                             ecm_b1,
+                                             ecm_b2,
+                                             ecm_curve_count,
+                                             ecm_factor_digits,
+                                             gnfs_degree,
+                                             gnfs_factor_base_bound,
+                                             gnfs_sieve_radius))
+    # 0 means the relation matrix was written for Block Wiedemann, instead of solved.
+    # (With sieve_only, it's left for merge_relations() to combine with other nodes' files.)
+    if (result == 0) and not sieve_only:
+        return block_wiedemann(matrix_file, wiedemann_process_count)
+    return result
+
+
+def merge_relations(matrix_files, matrix_file="", wiedemann_process_count=1):
+    result = int(_find_a_factor._merge_relations(list(matrix_files), matrix_file))
+    if result == 0:
+        return block_wiedemann(matrix_file, wiedemann_process_count)
+    return result
+
+
+def export_relations(matrix_file, relation_file):
+    _find_a_factor._export_relations(matrix_file, relation_file)
+
+
+def import_relations(n, relation_file, matrix_file):
+    _find_a_factor._import_relations(str(n), relation_file, matrix_file)
+
+
+def export_matrix(matrix_file, out_file, matrix_format="cado"):
+    _find_a_factor._export_matrix(matrix_file, out_file, matrix_format)
+
+
+def solve_dependencies(matrix_file, dependency_file):
+    return int(_find_a_factor._solve_dependencies(matrix_file, dependency_file))
+
+
+def pollard_rho_batch(numbers, max_iterations=0):
+    return [int(f) for f in _find_a_factor._pollard_rho_batch([str(n) for n in numbers], max_iterations)]
+
+
+def find_factors_u64(numbers):
+    # Factors are written in place, into one row of (at most) 15 distinct primes, and one of their exponents, per number.
+    numbers = numpy.ascontiguousarray(numbers, dtype=numpy.uint64)
+    primes = numpy.zeros(numbers.shape + (15,), dtype=numpy.uint64)
+    exponents = numpy.zeros(numbers.shape + (15,), dtype=numpy.uint8)
+    _find_a_factor._find_factors_u64(numbers.reshape(-1), primes.reshape(-1), exponents.reshape(-1))
+    return primes, exponents
+
+
+def factor_range(low, high, callback=None, segment_size=0):
+    # Every integer in [low, high] is factored, in the same rows as find_factors_u64(), by a segmented sieve.
+    # Without a callback, all rows come back at once; with one, callback(first, primes, exponents) sees each wave of
+    # rows in order, in reused arrays (so copy any rows to keep), and memory stays bounded by the wave size.
+    count = high - low + 1
+    if count < 1:
+        count = 0
+    if callback is None:
+        primes = numpy.zeros((count, 15), dtype=numpy.uint64)
+        exponents = numpy.zeros((count, 15), dtype=numpy.uint8)
+        if count:
+            _find_a_factor._factor_range(low, high, segment_size, primes.reshape(-1), exponents.reshape(-1), lambda first, n: None)
+        return primes, exponents
+    if not count:
+        return
+    # One segment per thread, per wave
+    wave = min(count, (segment_size if segment_size > 0 else 32768) * (os.cpu_count() or 1))
+    primes = numpy.zeros((wave, 15), dtype=numpy.uint64)
+    exponents = numpy.zeros((wave, 15), dtype=numpy.uint8)
+    _find_a_factor._factor_range(low, high, segment_size, primes.reshape(-1), exponents.reshape(-1), lambda first, n: callback(first, primes[:n], exponents[:n]))
+
+
+def block_wiedemann_part(matrix_file, part_id, part_count):
+    _find_a_factor._block_wiedemann_part(matrix_file, part_id, part_count)
+
+
+def block_wiedemann_solve(matrix_file, part_count):
+    return int(_find_a_factor._block_wiedemann_solve(matrix_file, part_count))
+
+
+def block_wiedemann(matrix_file, part_count=1):
+    # Every Krylov sequence part is computed by its own local process.
+    if part_count > 1:
+        with multiprocessing.Pool(part_count) as pool:
+            pool.starmap(block_wiedemann_part, [(matrix_file, i, part_count) for i in range(part_count)])
+    else:
+        block_wiedemann_part(matrix_file, 0, 1)
+    return block_wiedemann_solve(matrix_file, part_count)
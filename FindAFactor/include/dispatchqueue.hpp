@@ -30,6 +30,7 @@ public:
         , isFinished_(true)
         , isStarted_(false)
         , result(false)
+        , running_(0U)
     {
         // Intentionally left blank.
     }
@@ -62,6 +63,7 @@ private:
     bool isFinished_;
     bool isStarted_;
     bool result;
+    size_t running_;
 
     void dispatch_thread_handler(void);
 };
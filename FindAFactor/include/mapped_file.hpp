@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2017-2025. All rights reserved.
+//
+// "A quantum-inspired Monte Carlo integer factoring algorithm"
+//
+// Licensed under the MIT License.
+// See LICENSE.md in the project root or
+// https://opensource.org/license/mit for details.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+// Keep windows.h from defining macros (like "min" and "ERROR") that collide with our names.
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef NOGDI
+#define NOGDI
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Qimcifa {
+
+// A scratch file that is mapped into (virtual) memory, and deleted when closed.
+// The OS pages it in and out on demand, while prefetch() and release() steer which byte ranges stay resident.
+class MappedFile {
+public:
+  MappedFile(size_t size) : data_(nullptr), size_(size) {
+#if defined(_WIN32) && !defined(__CYGWIN__)
+    char dir[MAX_PATH + 1U];
+    char path[MAX_PATH + 1U];
+    if (!GetTempPathA(MAX_PATH + 1U, dir) || !GetTempFileNameA(dir, "faf", 0U, path)) {
+      throw std::runtime_error("Could not create matrix scratch file name!");
+    }
+    file_ = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0U, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+      throw std::runtime_error("Could not create matrix scratch file: " + std::string(path));
+    }
+    const uint64_t size64 = size;
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READWRITE, (DWORD)(size64 >> 32U), (DWORD)size64, nullptr);
+    if (!mapping_) {
+      CloseHandle(file_);
+      throw std::runtime_error("Could not size matrix scratch file!");
+    }
+    data_ = MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0U, 0U, size);
+    if (!data_) {
+      CloseHandle(mapping_);
+      CloseHandle(file_);
+      throw std::runtime_error("Could not map matrix scratch file!");
+    }
+#else
+    const char *tmpDir = std::getenv("TMPDIR");
+    std::string path = std::string((tmpDir && *tmpDir) ? tmpDir : "/tmp") + "/findafactor-XXXXXX";
+    fd_ = mkstemp(&(path[0U]));
+    if (fd_ < 0) {
+      throw std::runtime_error("Could not create matrix scratch file: " + path);
+    }
+    // The file lives on only as long as its descriptor.
+    unlink(path.c_str());
+    if (ftruncate(fd_, (off_t)size)) {
+      close(fd_);
+      throw std::runtime_error("Could not size matrix scratch file!");
+    }
+    data_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data_ == MAP_FAILED) {
+      close(fd_);
+      throw std::runtime_error("Could not map matrix scratch file!");
+    }
+#endif
+  }
+
+  ~MappedFile() {
+#if defined(_WIN32) && !defined(__CYGWIN__)
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+#else
+    munmap(data_, size_);
+    close(fd_);
+#endif
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  uint64_t *words() { return (uint64_t *)data_; }
+
+  // Ask for a range to be paged in ahead of use.
+  void prefetch(size_t offset, size_t length) {
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+    WIN32_MEMORY_RANGE_ENTRY entry;
+    if (align(offset, length, entry.VirtualAddress, entry.NumberOfBytes)) {
+      PrefetchVirtualMemory(GetCurrentProcess(), 1U, &entry, 0U);
+    }
+#endif
+#else
+    void *start;
+    size_t span;
+    if (align(offset, length, start, span)) {
+      madvise(start, span, MADV_WILLNEED);
+    }
+#endif
+  }
+
+  // Start writing a range back to the file, and let it leave resident memory.
+  // (Its contents are unchanged, and it pages back in if it is touched again.)
+  void release(size_t offset, size_t length) {
+#if defined(_WIN32) && !defined(__CYGWIN__)
+    void *start;
+    size_t span;
+    if (align(offset, length, start, span)) {
+      FlushViewOfFile(start, span);
+      // Unlocking pages that were never locked trims them from the working set.
+      VirtualUnlock(start, span);
+    }
+#else
+    void *start;
+    size_t span;
+    if (align(offset, length, start, span)) {
+      msync(start, span, MS_ASYNC);
+      madvise(start, span, MADV_DONTNEED);
+    }
+#endif
+  }
+
+private:
+  void *data_;
+  size_t size_;
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  HANDLE file_;
+  HANDLE mapping_;
+#else
+  int fd_;
+#endif
+
+  static size_t pageSize() {
+#if defined(_WIN32) && !defined(__CYGWIN__)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+  }
+
+  // Page-align a byte range outward, and clip it to the file.
+  bool align(size_t offset, size_t length, void *&start, size_t &span) const {
+    if (offset >= size_) {
+      return false;
+    }
+    const size_t page = pageSize();
+    const size_t end = ((offset + length) < size_) ? (offset + length) : size_;
+    const size_t first = (offset / page) * page;
+    start = (void *)((char *)data_ + first);
+    span = end - first;
+
+    return span > 0U;
+  }
+};
+
+} // namespace Qimcifa
@@ -59,7 +59,7 @@ setup(
         "Programming Language :: Python :: 3.10",
         "Topic :: Scientific/Engineering",
     ],
-    install_requires=["pybind11"],
+    install_requires=["pybind11", "numpy"],
     ext_modules=ext_modules,
     cmdclass=dict(build_ext=CMakeBuild),
     packages=['FindAFactor'],